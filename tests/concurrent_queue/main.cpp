@@ -0,0 +1,121 @@
+// The regression test of concurrent queues, multiple producers push sequences concurrently, the
+// consumer verify no element lost and the elements of each producer consumed in order.
+#include <stdio.h>
+#include <thread>
+#include <vector>
+#include "yasio/detail/concurrent_queue.hpp"
+
+using namespace yasio::concurrency;
+
+#define PRODUCER_COUNT 4
+#define ITEM_COUNT 200000
+#define RING_CAPACITY 64 // small ring, let producers overflow frequently
+#define BULK_SIZE 8
+
+struct mpsc_item : public mpsc_node
+{
+  mpsc_item(int producer, int seq) : producer_(producer), seq_(seq) {}
+  int producer_;
+  int seq_;
+};
+
+static int test_mpsc_queue()
+{
+  mpsc_queue<mpsc_item> queue;
+  std::vector<std::thread> producers;
+  for (int i = 0; i < PRODUCER_COUNT; ++i)
+    producers.push_back(std::thread([&queue, i] {
+      for (int seq = 0; seq < ITEM_COUNT; ++seq)
+        queue.push(new mpsc_item(i, seq));
+    }));
+
+  int expected[PRODUCER_COUNT] = {0};
+  int consumed = 0, errors = 0;
+  while (consumed < PRODUCER_COUNT * ITEM_COUNT)
+  {
+    // traverse the taken elements by next without remove, the order must be same with pop
+    int peeked = 0;
+    for (auto item = queue.peek(); item != nullptr && peeked < 16; item = queue.next(item))
+      ++peeked;
+
+    auto item = queue.pop();
+    if (item == nullptr)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    if (item->seq_ != expected[item->producer_]++)
+      ++errors;
+    ++consumed;
+    delete item;
+  }
+  for (auto& t : producers)
+    t.join();
+  if (!queue.empty())
+    ++errors;
+
+  printf("mpsc_queue: consumed: %d, errors: %d\n", consumed, errors);
+  return errors;
+}
+
+static int test_ring_queue()
+{
+  ring_queue<std::pair<int, int>> queue(RING_CAPACITY);
+  std::vector<std::thread> producers;
+  for (int i = 0; i < PRODUCER_COUNT; ++i)
+    producers.push_back(std::thread([&queue, i] {
+      std::vector<std::pair<int, int>> bulk;
+      for (int seq = 0; seq < ITEM_COUNT;)
+      {
+        if (i & 1)
+        { // odd producers push by bulk
+          for (; seq < ITEM_COUNT && bulk.size() < BULK_SIZE; ++seq)
+            bulk.push_back(std::make_pair(i, seq));
+          queue.emplace_bulk(bulk.begin(), bulk.end());
+          bulk.clear();
+        }
+        else
+          queue.emplace(std::make_pair(i, seq++));
+      }
+    }));
+
+  int expected[PRODUCER_COUNT] = {0};
+  int consumed = 0, errors = 0;
+  std::pair<int, int> item;
+  while (consumed < PRODUCER_COUNT * ITEM_COUNT)
+  {
+    if (!queue.try_pop(item))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    if (item.second != expected[item.first])
+    {
+      if (errors++ == 0)
+        printf("ring_queue: producer %d, seq %d, expected %d\n", item.first, item.second,
+               expected[item.first]);
+    }
+    expected[item.first] = item.second + 1;
+    ++consumed;
+  }
+  for (auto& t : producers)
+    t.join();
+  if (queue.try_pop(item))
+    ++errors;
+
+  printf("ring_queue: consumed: %d, errors: %d\n", consumed, errors);
+  return errors;
+}
+
+int main()
+{
+  int errors = test_mpsc_queue();
+  errors += test_ring_queue();
+  if (errors != 0)
+  {
+    printf("concurrent_queue test failed!\n");
+    return 1;
+  }
+  printf("concurrent_queue test passed.\n");
+  return 0;
+}
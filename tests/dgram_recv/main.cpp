@@ -0,0 +1,115 @@
+// The regression test of udp server recvmmsg slots, the datagrams larger than 2048 bytes must be
+// delivered intact by default, and when a smaller slot size set, the truncated datagrams are
+// dropped before any session made for them.
+#include <stdio.h>
+#include <atomic>
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+using namespace yasio::inet;
+
+#define SMALL_SLOT_SIZE 2048
+
+static const int dgram_sizes[] = {100, 3000, 20000, 60000, 1000};
+
+static std::vector<char> make_dgram(int size)
+{
+  std::vector<char> dgram(size);
+  for (int i = 0; i < size; ++i)
+    dgram[i] = static_cast<char>(i * 7 + size);
+  return dgram;
+}
+
+int main()
+{
+  // channel 0: server with default slots, channel 1: server with small slots
+  // channel 2: client of channel 0, channel 3: client of channel 1
+  io_hostent hosts[] = {{"127.0.0.1", 19981}, {"127.0.0.1", 19982},
+                        {"127.0.0.1", 19981}, {"127.0.0.1", 19982}};
+  io_service service(hosts, 4);
+
+  std::atomic<int> ready{0}, received[2] = {{0}, {0}}, sessions[2] = {{0}, {0}}, errors{0};
+  transport_handle_t clients[4] = {nullptr};
+  service.start([&](event_ptr&& event) {
+    int cindex = event->cindex();
+    switch (event->kind())
+    {
+      case YEK_CONNECT_RESPONSE:
+        if (cindex < 2)
+          ++sessions[cindex];
+        else if (event->status() == 0)
+        {
+          clients[cindex] = event->transport();
+          ++ready;
+        }
+        break;
+      case YEK_PACKET:
+        if (cindex < 2)
+        {
+          auto& packet = event->packet();
+          bool matched = false;
+          for (auto size : dgram_sizes)
+            if (packet == make_dgram(size))
+              matched = true;
+          if (!matched || (cindex == 1 && packet.size() > SMALL_SLOT_SIZE))
+            ++errors;
+          ++received[cindex];
+        }
+        break;
+    }
+  });
+
+  service.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR | YCF_UDP_DEMUX, 0);
+  service.set_option(YOPT_C_MOD_FLAGS, 1, YCF_REUSEADDR | YCF_UDP_DEMUX, 0);
+  service.open(0, YCK_UDP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  service.set_option(YOPT_S_DGRAM_RECV_BATCH, YASIO_DGRAM_RECV_BATCH, SMALL_SLOT_SIZE);
+  service.open(1, YCK_UDP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  service.open(2, YCK_UDP_CLIENT);
+  service.open(3, YCK_UDP_CLIENT);
+
+  auto start = highp_clock();
+  while (ready < 2 && highp_clock() - start < 3 * std::micro::den)
+  {
+    service.dispatch();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  // the first datagram to small slots server is truncated, no session should be made for it
+  service.write(clients[3], make_dgram(dgram_sizes[1]));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  service.dispatch();
+  int sessions_of_truncated = sessions[1];
+
+  int count = sizeof(dgram_sizes) / sizeof(dgram_sizes[0]), small = 0;
+  for (auto size : dgram_sizes)
+  {
+    service.write(clients[2], make_dgram(size));
+    service.write(clients[3], make_dgram(size));
+    if (size <= SMALL_SLOT_SIZE)
+      ++small;
+  }
+
+  start = highp_clock();
+  while ((received[0] < count || received[1] < small) &&
+         highp_clock() - start < 3 * std::micro::den)
+  {
+    service.dispatch();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  service.stop();
+
+  auto truncated = service.stats().dgrams_truncated.load();
+  printf("default slots received: %d/%d, small slots received: %d/%d, truncated: %llu\n",
+         received[0].load(), count, received[1].load(), small, truncated);
+  printf("sessions: %d/%d, sessions of truncated: %d, errors: %d\n", sessions[0].load(),
+         sessions[1].load(), sessions_of_truncated, errors.load());
+
+  bool ok = ready == 2 && errors == 0 && received[0] == count && sessions[0] == 1;
+#if defined(__linux__) // the slot size only works with recvmmsg
+  ok = ok && received[1] == small && truncated == static_cast<unsigned long long>(count - small + 1) &&
+       sessions[1] == 1 && sessions_of_truncated == 0;
+#endif
+  printf(ok ? "dgram_recv test passed.\n" : "dgram_recv test failed!\n");
+  return ok ? 0 : 1;
+}
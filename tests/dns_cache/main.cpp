@@ -0,0 +1,108 @@
+// The regression test of shared dns cache, the channels resolve same host concurrently must be
+// coalesced into one query, the channels open later hit the cache, and the service stop without waiting the slow
+// query in flight.
+#include <stdio.h>
+#include <atomic>
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+using namespace yasio::inet;
+
+#define CLIENT_COUNT 100
+#define LATE_COUNT 10
+#define RESOLVE_LATENCY 200 // milliseconds
+#define SLOW_RESOLVE_LATENCY 2000
+
+// the resolver may called after the service destroyed, so the counters are global
+static std::atomic<int> s_resolves{0};
+
+static int fake_resolv(std::vector<ip::endpoint>& eps, const char* host, unsigned short port)
+{
+  ++s_resolves;
+  bool slow = strcmp(host, "slow.test") == 0;
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(slow ? SLOW_RESOLVE_LATENCY : RESOLVE_LATENCY));
+  eps.push_back(ip::endpoint("127.0.0.1", port));
+  return 0;
+}
+
+static int test_coalesce()
+{
+  std::vector<io_hostent> hosts(CLIENT_COUNT + LATE_COUNT + 1, io_hostent{"fake.test", 19985});
+  hosts[0].host_ = "127.0.0.1";
+  io_service service(hosts.data(), static_cast<int>(hosts.size()));
+  resolv_fn_t resolv = fake_resolv;
+  service.set_option(YOPT_S_RESOLV_FN, &resolv);
+  service.set_option(YOPT_S_TCP_BACKLOG, CLIENT_COUNT + LATE_COUNT);
+  service.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+
+  int connected = 0, failed = 0;
+  service.start([&](event_ptr&& event) {
+    if (event->kind() == YEK_CONNECT_RESPONSE && event->cindex() != 0)
+      ++(event->status() == 0 ? connected : failed);
+  });
+  service.open(0, YCK_TCP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  auto wait = [&](int count) {
+    auto start = highp_clock();
+    while (connected + failed < count && highp_clock() - start < 5 * std::micro::den)
+    {
+      service.dispatch(1024);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  };
+  s_resolves = 0;
+  for (int i = 1; i <= CLIENT_COUNT; ++i)
+    service.open(i, YCK_TCP_CLIENT);
+  wait(CLIENT_COUNT);
+  int resolves = s_resolves;
+
+  // the record still fresh, no query
+  auto start = highp_clock();
+  for (int i = CLIENT_COUNT + 1; i <= CLIENT_COUNT + LATE_COUNT; ++i)
+    service.open(i, YCK_TCP_CLIENT);
+  wait(CLIENT_COUNT + LATE_COUNT);
+  long long late_ms = (highp_clock() - start) / 1000;
+
+  auto& stats = service.stats();
+  printf("coalesce: connected=%d, failed=%d, resolves=%d/%d, misses=%llu, coalesced=%llu, "
+         "hits=%llu, late=%lldms\n",
+         connected, failed, resolves, s_resolves.load(), stats.dns_cache_misses.load(),
+         stats.dns_queries_coalesced.load(), stats.dns_cache_hits.load(), late_ms);
+  service.stop();
+
+  bool ok = connected == CLIENT_COUNT + LATE_COUNT && failed == 0 && resolves == 1 &&
+            s_resolves == 1 && stats.dns_cache_misses == 1 &&
+            stats.dns_queries_coalesced == CLIENT_COUNT - 1 &&
+            stats.dns_cache_hits == LATE_COUNT && late_ms < RESOLVE_LATENCY;
+  return ok ? 0 : 1;
+}
+
+static int test_stop()
+{
+  auto start = highp_clock();
+  {
+    io_hostent hosts[] = {{"slow.test", 19986}};
+    io_service service(hosts, 1);
+    resolv_fn_t resolv = fake_resolv;
+    service.set_option(YOPT_S_RESOLV_FN, &resolv);
+    service.start([](event_ptr&&) {});
+    service.open(0, YCK_TCP_CLIENT);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  } // destroyed when the query in flight
+  long long elapsed = (highp_clock() - start) / 1000;
+  printf("stop: elapsed=%lldms\n", elapsed);
+
+  // wait the detached resolver complete
+  std::this_thread::sleep_for(std::chrono::milliseconds(SLOW_RESOLVE_LATENCY));
+  return elapsed < SLOW_RESOLVE_LATENCY / 2 ? 0 : 1;
+}
+
+int main()
+{
+  int errors = test_coalesce();
+  errors += test_stop();
+  printf(errors == 0 ? "dns_cache test passed.\n" : "dns_cache test failed!\n");
+  return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+// The regression test of dns background refresh, the record referenced by open channel must be
+// refreshed by timer after the prefetch threshold, so the channel open later not wait the query,
+// and the refresh stopped when no channel references the record.
+#include <stdio.h>
+#include <atomic>
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+using namespace yasio::inet;
+
+#define RESOLVE_LATENCY 200 // milliseconds
+#define CACHE_TIMEOUT 1     // seconds
+#define PREFETCH_THRESHOLD 50
+
+static std::atomic<int> s_resolves{0};
+
+static int fake_resolv(std::vector<ip::endpoint>& eps, const char*, unsigned short port)
+{
+  ++s_resolves;
+  std::this_thread::sleep_for(std::chrono::milliseconds(RESOLVE_LATENCY));
+  eps.push_back(ip::endpoint("127.0.0.1", port));
+  return 0;
+}
+
+int main()
+{
+  io_hostent hosts[] = {{"127.0.0.1", 19987}, {"fake.test", 19987}, {"fake.test", 19987}};
+  io_service service(hosts, YASIO_ARRAYSIZE(hosts));
+  resolv_fn_t resolv = fake_resolv;
+  service.set_option(YOPT_S_RESOLV_FN, &resolv);
+  service.set_option(YOPT_S_DNS_CACHE_TIMEOUT, CACHE_TIMEOUT);
+  service.set_option(YOPT_S_DNS_MAX_STALENESS, 0); // the expired record never used
+  service.set_option(YOPT_S_DNS_PREFETCH_THRESHOLD, PREFETCH_THRESHOLD);
+  service.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+
+  int responses = 0, status = -1;
+  service.start([&](event_ptr&& event) {
+    if (event->kind() == YEK_CONNECT_RESPONSE && event->cindex() != 0)
+    {
+      ++responses;
+      status = event->status();
+    }
+  });
+  service.open(0, YCK_TCP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  auto wait = [&](int count, long long timeout_ms) {
+    auto start = highp_clock();
+    while (responses < count && highp_clock() - start < timeout_ms * 1000)
+    {
+      service.dispatch();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return (highp_clock() - start) / 1000;
+  };
+
+  int errors = 0;
+  service.open(1, YCK_TCP_CLIENT);
+  long long latency = wait(1, 3000);
+  printf("first open: status=%d, latency=%lldms, resolves=%d\n", status, latency,
+         s_resolves.load());
+  errors += status != 0;
+
+  // keep channel 1 connected beyond cache timeout, the record refreshed at background
+  wait(2, CACHE_TIMEOUT * 1500);
+  int resolves = s_resolves;
+  service.open(2, YCK_TCP_CLIENT);
+  latency = wait(2, 3000);
+  printf("open after timeout: status=%d, latency=%lldms, resolves=%d, prefetches=%llu\n", status,
+         latency, resolves, service.stats().dns_prefetches.load());
+  errors += status != 0 || latency >= RESOLVE_LATENCY / 2 || resolves < 2 ||
+            service.stats().dns_prefetches == 0;
+
+  // no channel references the record, the refresh stopped
+  service.close(1);
+  service.close(2);
+  wait(3, RESOLVE_LATENCY + 100);
+  resolves = s_resolves;
+  wait(3, CACHE_TIMEOUT * 1500);
+  printf("after close: resolves=%d/%d\n", resolves, s_resolves.load());
+  errors += resolves != s_resolves;
+  service.stop();
+
+  printf(errors == 0 ? "dns_refresh test passed.\n" : "dns_refresh test failed!\n");
+  return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+// The regression test of the length field based frame decoder, the server writes bursts of many
+// frames per write to every client, each client decodes them with different LFBFD params &
+// initial bytes to strip, all frames must arrive intact and in order.
+#include <stdio.h>
+#include <atomic>
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+using namespace yasio::inet;
+
+#define BURST_COUNT 100
+#define FRAME_COUNT 200
+#define BIG_FRAME_SIZE 70000
+
+enum
+{
+  MODE_LEN4_IBTS0 = 1, // 4 bytes length excludes header, keep header
+  MODE_LEN4_IBTS4,     // 4 bytes length excludes header, strip header
+  MODE_LEN2_OFFSET2,   // 2 bytes tag + 2 bytes length excludes header, strip header
+  MODE_LEN4_INCLUSIVE, // 4 bytes length includes header, strip header
+  MODE_RAW,            // no length field, raw stream
+  MODE_COUNT
+};
+
+static int payload_size(int seq)
+{
+  return (seq % 50 == 49) ? BIG_FRAME_SIZE : (seq * 13) % 97 + 1;
+}
+
+static void append_frame(std::vector<char>& buf, int mode, int seq)
+{
+  int len = mode == MODE_LEN2_OFFSET2 ? (seq * 13) % 97 + 1 : payload_size(seq);
+  switch (mode)
+  {
+    case MODE_LEN2_OFFSET2: {
+      uint16_t tag = htons(static_cast<uint16_t>(seq)), n = htons(static_cast<uint16_t>(len));
+      buf.insert(buf.end(), (char*)&tag, (char*)&tag + 2);
+      buf.insert(buf.end(), (char*)&n, (char*)&n + 2);
+      break;
+    }
+    case MODE_LEN4_INCLUSIVE: {
+      uint32_t n = htonl(len + 4);
+      buf.insert(buf.end(), (char*)&n, (char*)&n + 4);
+      break;
+    }
+    default: {
+      uint32_t n = htonl(len);
+      buf.insert(buf.end(), (char*)&n, (char*)&n + 4);
+    }
+  }
+  for (int i = 0; i < len; ++i)
+    buf.push_back(static_cast<char>(seq + i));
+}
+
+int main()
+{
+  std::vector<io_hostent> hosts(MODE_COUNT, io_hostent{"127.0.0.1", 19971});
+  io_service service(hosts.data(), static_cast<int>(hosts.size()));
+
+  service.set_option(YOPT_C_LFBFD_PARAMS, MODE_LEN4_IBTS0, 1024 * 1024, 0, 4, 4);
+  service.set_option(YOPT_C_LFBFD_PARAMS, MODE_LEN4_IBTS4, 1024 * 1024, 0, 4, 4);
+  service.set_option(YOPT_C_LFBFD_IBTS, MODE_LEN4_IBTS4, 4);
+  service.set_option(YOPT_C_LFBFD_PARAMS, MODE_LEN2_OFFSET2, 1024 * 1024, 2, 2, 4);
+  service.set_option(YOPT_C_LFBFD_IBTS, MODE_LEN2_OFFSET2, 4);
+  service.set_option(YOPT_C_LFBFD_PARAMS, MODE_LEN4_INCLUSIVE, 1024 * 1024, 0, 4, 0);
+  service.set_option(YOPT_C_LFBFD_IBTS, MODE_LEN4_INCLUSIVE, 4);
+  service.set_option(YOPT_C_LFBFD_PARAMS, MODE_RAW, 1024 * 1024, -1, 0, 0);
+
+  // the expected raw stream of MODE_RAW is the frames of MODE_LEN4_IBTS0
+  std::vector<char> raw_expected;
+  for (int seq = 0; seq < BURST_COUNT * FRAME_COUNT; ++seq)
+    append_frame(raw_expected, MODE_LEN4_IBTS0, seq);
+
+  std::atomic<int> errors{0}, ready{0};
+  std::atomic<size_t> raw_received{0};
+  int received[MODE_COUNT] = {0};
+  std::vector<std::pair<transport_handle_t, int>> peers; // the accepted transport & it's mode
+  service.start([&](event_ptr&& event) {
+    if (event->cindex() == 0)
+    { // server, every client says it's mode by the first byte
+      if (event->kind() == YEK_PACKET && !event->packet().empty())
+      {
+        peers.push_back(std::make_pair(event->transport(), (int)event->packet()[0]));
+        ++ready;
+      }
+      return;
+    }
+    int mode = event->cindex();
+    if (event->kind() == YEK_CONNECT_RESPONSE && event->status() == 0)
+      service.write(event->transport(), std::vector<char>(1, static_cast<char>(mode)));
+    else if (event->kind() == YEK_PACKET)
+    {
+      auto& packet = event->packet();
+      if (mode == MODE_RAW)
+      {
+        size_t offset = raw_received;
+        if (offset + packet.size() > raw_expected.size() ||
+            memcmp(raw_expected.data() + offset, packet.data(), packet.size()) != 0)
+          ++errors;
+        raw_received += packet.size();
+        return;
+      }
+      int seq = received[mode]++;
+      std::vector<char> expected;
+      append_frame(expected, mode, seq);
+      size_t strip = mode == MODE_LEN4_IBTS0 ? 0 : 4;
+      if (packet.size() != expected.size() - strip ||
+          memcmp(expected.data() + strip, packet.data(), packet.size()) != 0)
+      {
+        if (errors++ == 0)
+          printf("mode %d frame %d mismatch, size=%zu expected=%zu\n", mode, seq, packet.size(),
+                 expected.size() - strip);
+      }
+    }
+  });
+  service.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+  service.open(0, YCK_TCP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  for (int i = 1; i < MODE_COUNT; ++i)
+    service.open(i, YCK_TCP_CLIENT);
+
+  auto start = highp_clock();
+  while (ready < MODE_COUNT - 1 && highp_clock() - start < 3 * std::micro::den)
+  {
+    service.dispatch();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  for (auto& peer : peers)
+  {
+    int mode = peer.second == MODE_RAW ? MODE_LEN4_IBTS0 : peer.second;
+    for (int b = 0, seq = 0; b < BURST_COUNT; ++b)
+    {
+      std::vector<char> burst;
+      for (int f = 0; f < FRAME_COUNT; ++f, ++seq)
+        append_frame(burst, mode, seq);
+      service.write(peer.first, std::move(burst));
+    }
+  }
+
+  auto done = [&]() {
+    for (int i = MODE_LEN4_IBTS0; i < MODE_RAW; ++i)
+      if (received[i] < BURST_COUNT * FRAME_COUNT)
+        return false;
+    return raw_received >= raw_expected.size();
+  };
+  start = highp_clock();
+  while (!done() && highp_clock() - start < 10 * std::micro::den)
+    service.dispatch(1024);
+  service.stop();
+
+  for (int i = MODE_LEN4_IBTS0; i < MODE_RAW; ++i)
+    printf("mode %d: received frames: %d/%d\n", i, received[i], BURST_COUNT * FRAME_COUNT);
+  printf("mode %d: received bytes: %zu/%zu\n", (int)MODE_RAW, raw_received.load(),
+         raw_expected.size());
+  printf("errors: %d\n", errors.load());
+
+  bool ok = ready == MODE_COUNT - 1 && done() && errors == 0;
+  printf(ok ? "frame_decode test passed.\n" : "frame_decode test failed!\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+// The regression test of happy eyeballs connect, the custom resolver returns endpoints of both
+// families with refused & blackhole ones, the client must fallback to the next endpoint in the
+// interleaved order, immediately when failed or after the attempt delay when no response.
+#include <stdio.h>
+#include <string.h>
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+using namespace yasio::inet;
+
+#define SERVER_PORT 19991
+#define REFUSED_PORT 19992
+#define BLACKHOLE_PORT 19993
+#define ATTEMPT_DELAY 100 // milliseconds
+
+struct test_case
+{
+  const char* host;
+  int status;       // the expected connect status, -1: any error
+  int af;           // the expected family of connected peer, 0: not connected
+  long long min_ms; // the elapsed range of connect response
+  long long max_ms;
+};
+
+int main()
+{
+  // the listener never accept with the backlog filled, the SYN of later connects are dropped
+  xxsocket blackhole, filler;
+  blackhole.open(AF_INET, SOCK_STREAM);
+  blackhole.reuse_address(true);
+  if (blackhole.bind("127.0.0.1", BLACKHOLE_PORT) != 0 || blackhole.listen(0) != 0 ||
+      filler.xpconnect_n("127.0.0.1", BLACKHOLE_PORT, std::chrono::seconds(1)) != 0)
+  {
+    printf("happy_eyeballs test failed! can't create blackhole listener.\n");
+    return 1;
+  }
+
+  io_hostent hosts[] = {{"127.0.0.1", SERVER_PORT}, {"::1", SERVER_PORT}, {"", SERVER_PORT}};
+  io_service service(hosts, YASIO_ARRAYSIZE(hosts));
+  resolv_fn_t resolv = [](std::vector<ip::endpoint>& eps, const char* host, unsigned short port) {
+    ip::endpoint refused4("127.0.0.1", REFUSED_PORT), refused6("::1", REFUSED_PORT);
+    ip::endpoint server4("127.0.0.1", port), server6("::1", port);
+    ip::endpoint blackhole4("127.0.0.1", BLACKHOLE_PORT);
+    if (!strcmp(host, "refused.test"))
+      eps = {refused4, server4};
+    else if (!strcmp(host, "stagger.test"))
+      eps = {blackhole4, server4};
+    else if (!strcmp(host, "interleave4.test")) // interleaved: refused6, server4, server6
+      eps = {refused6, server6, server4};
+    else if (!strcmp(host, "interleave6.test")) // interleaved: refused4, server6, refused4, server4
+      eps = {refused4, refused4, server4, server6};
+    else if (!strcmp(host, "failed.test"))
+      eps = {refused4, refused6};
+    else if (!strcmp(host, "timeout.test"))
+      eps = {blackhole4};
+    return eps.empty() ? -1 : 0;
+  };
+  service.set_option(YOPT_S_RESOLV_FN, &resolv);
+  service.set_option(YOPT_S_CONNECT_TIMEOUT, 1);
+  service.set_option(YOPT_S_CONNECT_ATTEMPT_DELAY, ATTEMPT_DELAY);
+  service.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+  service.set_option(YOPT_C_MOD_FLAGS, 1, YCF_REUSEADDR, 0);
+
+  int status = 0, af = 0;
+  bool responded = false;
+  service.start([&](event_ptr&& event) {
+    if (event->kind() == YEK_CONNECT_RESPONSE && event->cindex() == 2)
+    {
+      responded = true;
+      status    = event->status();
+      af        = status == 0 ? event->transport()->peer_endpoint().af() : 0;
+    }
+  });
+  service.open(0, YCK_TCP_SERVER);
+  service.open(1, YCK_TCP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  // the ipv6 loopback may not available
+  xxsocket probe;
+  bool has_ipv6 = probe.open(AF_INET6, SOCK_STREAM) && probe.bind("::1", 0) == 0;
+
+  test_case cases[] = {
+      {"refused.test", 0, AF_INET, 0, ATTEMPT_DELAY - 10},
+      {"stagger.test", 0, AF_INET, ATTEMPT_DELAY - 10, 1000 - 10},
+      {"interleave4.test", 0, AF_INET, 0, ATTEMPT_DELAY - 10},
+      {"interleave6.test", 0, has_ipv6 ? AF_INET6 : AF_INET, 0, ATTEMPT_DELAY - 10},
+      {"failed.test", -1, 0, 0, ATTEMPT_DELAY - 10},
+      {"timeout.test", ETIMEDOUT, 0, 1000 - 10, 2000},
+  };
+  int errors = 0;
+  for (auto& item : cases)
+  {
+    responded = false;
+    service.set_option(YOPT_C_REMOTE_HOST, 2, item.host);
+    auto start = highp_clock();
+    service.open(2, YCK_TCP_CLIENT);
+    while (!responded && highp_clock() - start < 3 * std::micro::den)
+    {
+      service.dispatch();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    long long elapsed = (highp_clock() - start) / 1000;
+    bool ok           = responded && (item.status == -1 ? status != 0 : status == item.status) &&
+              af == item.af && elapsed >= item.min_ms && elapsed <= item.max_ms;
+    printf("%s: status=%d, af=%d, elapsed=%lldms, %s\n", item.host, status, af, elapsed,
+           ok ? "ok" : "failed");
+    errors += !ok;
+
+    service.close(2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    service.dispatch();
+  }
+  service.stop();
+
+  printf(errors == 0 ? "happy_eyeballs test passed.\n" : "happy_eyeballs test failed!\n");
+  return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+// The regression test of concurrent object pool, the worker threads keep running while pools
+// created & destroyed, the magazines of destroyed pools must be released, so the thread local
+// cache still works for the pools created later.
+#include <stdio.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "yasio/detail/object_pool.hpp"
+
+using namespace yasio;
+
+#define WORKER_COUNT 4
+#define ROUND_COUNT 32 // more than YASIO_POOL_MAX_MAGAZINES
+#define OBJECT_COUNT 1000
+#define LOOP_COUNT 20
+
+struct object
+{
+  object(int value) : value_(value) {}
+  int value_;
+};
+
+// Count the lock of pool, the magazines only lock the pool when it's empty or full
+struct counting_mutex
+{
+  void lock()
+  {
+    mtx_.lock();
+    ++locks_;
+  }
+  void unlock() { mtx_.unlock(); }
+  std::mutex mtx_;
+  std::atomic<int> locks_{0};
+};
+
+int main()
+{
+  std::mutex mtx;
+  std::condition_variable cv;
+  gc::object_pool<object, counting_mutex>* pool = nullptr;
+  int round = -1, finished = 0;
+  std::atomic<int> errors{0};
+
+  std::vector<std::thread> workers;
+  for (int i = 0; i < WORKER_COUNT; ++i)
+    workers.push_back(std::thread([&] {
+      std::vector<object*> objects;
+      for (int r = 0; r < ROUND_COUNT; ++r)
+      {
+        std::unique_lock<std::mutex> lck(mtx);
+        cv.wait(lck, [&] { return round >= r; });
+        auto p = pool;
+        lck.unlock();
+
+        for (int n = 0; n < LOOP_COUNT; ++n)
+        {
+          for (int k = 0; k < OBJECT_COUNT; ++k)
+            objects.push_back(p->construct(k));
+          for (int k = 0; k < OBJECT_COUNT; ++k)
+          {
+            if (objects[k]->value_ != k)
+              ++errors;
+            p->destroy(objects[k]);
+          }
+          objects.clear();
+        }
+        // keep some elements cached in the magazine of this thread when pool destroyed
+        p->destroy(p->construct(0));
+
+        lck.lock();
+        ++finished;
+        cv.notify_all();
+      }
+    }));
+
+  int last_locks = 0;
+  for (int r = 0; r < ROUND_COUNT; ++r)
+  {
+    std::unique_lock<std::mutex> lck(mtx);
+    pool     = new gc::object_pool<object, counting_mutex>();
+    finished = 0;
+    round    = r;
+    cv.notify_all();
+    cv.wait(lck, [&] { return finished == WORKER_COUNT; });
+    last_locks = pool->mutex_.locks_;
+    delete pool;
+    pool = nullptr;
+  }
+  for (auto& t : workers)
+    t.join();
+
+  // without magazines, every construct & destroy lock the pool
+  int operations = WORKER_COUNT * LOOP_COUNT * OBJECT_COUNT * 2;
+  printf("locks of last round: %d, operations: %d, errors: %d\n", last_locks, operations,
+         errors.load());
+  bool ok = errors == 0 && last_locks < operations / 4;
+  printf(ok ? "object_pool test passed.\n" : "object_pool test failed!\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+// The benchmark of concurrent object pool, compare the thread local magazines with the
+// mutex only pool, usage: pool_bench [rounds]
+#include <stdio.h>
+#include <stdlib.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+
+#define BATCH_SIZE 64
+
+// The pool with thread local magazines
+struct magazine_object
+{
+  char data[64];
+  DEFINE_CONCURRENT_OBJECT_POOL_ALLOCATION(magazine_object, 512)
+};
+
+// The pool serialize every allocation and free by one mutex
+struct mutex_object
+{
+  char data[64];
+
+  static void* operator new(size_t /*size*/)
+  {
+    std::lock_guard<std::mutex> lck(get_mutex());
+    return get_pool().get();
+  }
+  static void operator delete(void* p)
+  {
+    std::lock_guard<std::mutex> lck(get_mutex());
+    get_pool().release(p);
+  }
+  static gc::detail::object_pool& get_pool()
+  {
+    static gc::detail::object_pool s_pool(YASIO_POOL_ESTIMATE_SIZE(mutex_object), 512);
+    return s_pool;
+  }
+  static std::mutex& get_mutex()
+  {
+    static std::mutex s_mutex;
+    return s_mutex;
+  }
+};
+
+// Each thread allocate a batch of objects then free them, returns allocations per second
+template <typename _Ty> double run(int threads, int rounds)
+{
+  std::vector<std::thread> workers;
+  auto start = highp_clock();
+  for (int i = 0; i < threads; ++i)
+    workers.push_back(std::thread([=] {
+      _Ty* objs[BATCH_SIZE];
+      for (int r = 0; r < rounds; ++r)
+      {
+        for (int k = 0; k < BATCH_SIZE; ++k)
+          objs[k] = new _Ty();
+        for (int k = 0; k < BATCH_SIZE; ++k)
+          delete objs[k];
+      }
+    }));
+  for (auto& worker : workers)
+    worker.join();
+  auto elapsed = highp_clock() - start;
+  return static_cast<double>(threads) * rounds * BATCH_SIZE * std::micro::den / elapsed;
+}
+
+// The objects allocated at producer threads and freed at consumer threads, like io_event
+template <typename _Ty> double run_pipe(int pairs, int rounds)
+{
+  std::vector<std::thread> workers;
+  std::vector<std::unique_ptr<concurrency::ring_queue<_Ty*>>> queues;
+  for (int i = 0; i < pairs; ++i)
+    queues.push_back(std::unique_ptr<concurrency::ring_queue<_Ty*>>(
+        new concurrency::ring_queue<_Ty*>(1024)));
+  auto start = highp_clock();
+  for (int i = 0; i < pairs; ++i)
+  {
+    auto q = queues[i].get();
+    workers.push_back(std::thread([=] {
+      for (int n = rounds * BATCH_SIZE; n > 0; --n)
+        q->emplace(new _Ty());
+    }));
+    workers.push_back(std::thread([=] {
+      int n = rounds * BATCH_SIZE;
+      _Ty* obj;
+      while (n > 0)
+      {
+        if (q->try_pop(obj))
+        {
+          delete obj;
+          --n;
+        }
+        else
+          std::this_thread::yield();
+      }
+    }));
+  }
+  for (auto& worker : workers)
+    worker.join();
+  auto elapsed = highp_clock() - start;
+  return static_cast<double>(pairs) * rounds * BATCH_SIZE * std::micro::den / elapsed;
+}
+
+int main(int argc, char** argv)
+{
+  int rounds = argc > 1 ? atoi(argv[1]) : 20000;
+
+  printf("magazine size: %d, batch size: %d, rounds: %d\n", YASIO_POOL_MAGAZINE_SIZE, BATCH_SIZE,
+         rounds);
+  printf("%-8s %18s %18s\n", "threads", "magazine(Mops/s)", "mutex(Mops/s)");
+  for (int threads = 1; threads <= 16; threads *= 2)
+    printf("%-8d %18.2f %18.2f\n", threads, run<magazine_object>(threads, rounds) / 1e6,
+           run<mutex_object>(threads, rounds) / 1e6);
+
+  printf("\n%-8s %18s %18s\n", "pairs", "magazine(Mops/s)", "mutex(Mops/s)");
+  for (int pairs = 1; pairs <= 8; pairs *= 2)
+    printf("%-8d %18.2f %18.2f\n", pairs, run_pipe<magazine_object>(pairs, rounds / 4) / 1e6,
+           run_pipe<mutex_object>(pairs, rounds / 4) / 1e6);
+  return 0;
+}
@@ -0,0 +1,110 @@
+// The regression test of YOPT_S_READ_BUDGET, the server writes much more than the budget to
+// clients, the data left in socket when budget exhausted must be read at next loop iteration
+// without new readiness, every byte & frame must arrive.
+#include <stdio.h>
+#include <atomic>
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+using namespace yasio::inet;
+
+#define READ_BUDGET 4096
+#define READ_FRAME_BUDGET 8
+#define STREAM_SIZE (8 * 1024 * 1024)
+#define FRAME_SIZE 64
+#define FRAME_COUNT 50000
+
+int main()
+{
+  io_hostent hosts[] = {{"127.0.0.1", 19981}, {"127.0.0.1", 19981}, {"127.0.0.1", 19981}};
+  io_service service(hosts, YASIO_ARRAYSIZE(hosts));
+  service.set_option(YOPT_S_READ_BUDGET, READ_BUDGET, READ_FRAME_BUDGET);
+  service.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+  // client 1 receive raw stream, exhaust the bytes budget
+  service.set_option(YOPT_C_LFBFD_PARAMS, 1, 1024 * 1024, -1, 0, 0);
+  // client 2 receive small frames, exhaust the frames budget
+  service.set_option(YOPT_C_LFBFD_PARAMS, 2, 1024 * 1024, 0, 4, 4);
+  service.set_option(YOPT_C_LFBFD_IBTS, 2, 4);
+
+  std::atomic<int> errors{0}, ready{0};
+  size_t bytes = 0;
+  int frames   = 0;
+  std::vector<std::pair<transport_handle_t, int>> peers; // the accepted transport & it's client
+  service.start([&](event_ptr&& event) {
+    switch (event->cindex())
+    {
+      case 0: // every client says it's index by the first byte
+        if (event->kind() == YEK_PACKET && !event->packet().empty())
+        {
+          peers.push_back(std::make_pair(event->transport(), (int)event->packet()[0]));
+          ++ready;
+        }
+        break;
+      case 1:
+        if (event->kind() == YEK_CONNECT_RESPONSE && event->status() == 0)
+          service.write(event->transport(), std::vector<char>(1, 1));
+        else if (event->kind() == YEK_PACKET)
+        {
+          for (auto ch : event->packet())
+            if (ch != static_cast<char>(bytes++ % 251))
+              ++errors;
+        }
+        break;
+      case 2:
+        if (event->kind() == YEK_CONNECT_RESPONSE && event->status() == 0)
+          service.write(event->transport(), std::vector<char>(1, 2));
+        else if (event->kind() == YEK_PACKET)
+        {
+          auto& packet = event->packet();
+          if (packet.size() != FRAME_SIZE || packet[0] != static_cast<char>(frames))
+            ++errors;
+          ++frames;
+        }
+        break;
+    }
+  });
+  service.open(0, YCK_TCP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  service.open(1, YCK_TCP_CLIENT);
+  service.open(2, YCK_TCP_CLIENT);
+
+  auto start = highp_clock();
+  while (ready < 2 && highp_clock() - start < 3 * std::micro::den)
+  {
+    service.dispatch();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  for (auto& peer : peers)
+  {
+    std::vector<char> data;
+    if (peer.second == 1)
+    {
+      data.resize(STREAM_SIZE);
+      for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<char>(i % 251);
+    }
+    else
+    {
+      for (int i = 0; i < FRAME_COUNT; ++i)
+      {
+        uint32_t n = htonl(FRAME_SIZE);
+        data.insert(data.end(), (char*)&n, (char*)&n + 4);
+        data.insert(data.end(), FRAME_SIZE, static_cast<char>(i));
+      }
+    }
+    service.write(peer.first, std::move(data));
+  }
+
+  start = highp_clock();
+  while ((bytes < STREAM_SIZE || frames < FRAME_COUNT) &&
+         highp_clock() - start < 10 * std::micro::den)
+    service.dispatch(1024);
+  service.stop();
+
+  unsigned long long exhausted = service.stats().read_budget_exhausted;
+  printf("received bytes: %zu/%d, frames: %d/%d, budget exhausted: %llu, errors: %d\n", bytes,
+         STREAM_SIZE, frames, FRAME_COUNT, exhausted, errors.load());
+  bool ok = bytes == STREAM_SIZE && frames == FRAME_COUNT && exhausted > 0 && errors == 0;
+  printf(ok ? "read_budget test passed.\n" : "read_budget test failed!\n");
+  return ok ? 0 : 1;
+}
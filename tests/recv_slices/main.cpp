@@ -0,0 +1,101 @@
+// The regression test of YCF_RECV_SLICES, the client receives frames as slices of the pooled
+// receive blocks, big frames fall back to packets, every frame must keep it's content while the
+// events hold the blocks after more data arrived.
+#include <stdio.h>
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+using namespace yasio::inet;
+
+#define FRAME_COUNT 20000
+#define HOLD_COUNT 50
+
+static int frame_size(int seq)
+{
+  return seq % 97 == 0 ? 70000 + seq % 1000 : (seq * 131) % 3000 + 1;
+}
+
+int main()
+{
+  io_hostent hosts[] = {{"127.0.0.1", 19931}, {"127.0.0.1", 19931}};
+  io_service service(hosts, YASIO_ARRAYSIZE(hosts));
+  service.set_option(YOPT_C_LFBFD_PARAMS, 1, 1024 * 1024, 0, 4, 4);
+  service.set_option(YOPT_C_LFBFD_IBTS, 1, 4);
+  service.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+  service.set_option(YOPT_C_MOD_FLAGS, 1, YCF_RECV_SLICES, 0);
+
+  int received = 0, errors = 0, sliced = 0;
+  // keep some events alive, the blocks held by them must not be reused
+  std::vector<std::pair<int, event_ptr>> checks;
+  service.start([&](event_ptr&& event) {
+    if (event->kind() == YEK_CONNECT_RESPONSE && event->cindex() == 0 && event->status() == 0)
+    {
+      auto transport = event->transport();
+      for (int seq = 0; seq < FRAME_COUNT; ++seq)
+      {
+        int len = frame_size(seq);
+        std::vector<char> frame(4 + len);
+        uint32_t n = htonl(len);
+        memcpy(frame.data(), &n, 4);
+        for (int i = 0; i < len; ++i)
+          frame[4 + i] = static_cast<char>(seq + i);
+        service.write(transport, std::move(frame));
+      }
+    }
+    else if (event->kind() == YEK_PACKET && event->cindex() == 1)
+    {
+      int seq   = received++;
+      auto view = event->packet_view();
+      // even frames are checked by packet() which copies the slice out, odd frames by view
+      std::vector<char> copy;
+      const char* data = view.data();
+      size_t size      = view.size();
+      if (!(seq & 1))
+      {
+        if (view.data() != event->packet().data())
+          ++sliced;
+        copy = event->packet();
+        data = copy.data();
+        size = copy.size();
+      }
+      bool ok = static_cast<int>(size) == frame_size(seq);
+      for (size_t i = 0; ok && i < size; ++i)
+        ok = data[i] == static_cast<char>(seq + i);
+      if (!ok)
+        ++errors;
+      if (seq % 3 == 0)
+        checks.push_back(std::make_pair(seq, std::move(event)));
+      if (checks.size() > HOLD_COUNT)
+      { // recheck the held events after more frames received
+        for (auto& check : checks)
+        {
+          auto held_view = check.second->packet_view();
+          ok             = static_cast<int>(held_view.size()) == frame_size(check.first);
+          for (size_t i = 0; ok && i < held_view.size(); ++i)
+            ok = held_view.data()[i] == static_cast<char>(check.first + i);
+          if (!ok)
+            ++errors;
+        }
+        checks.clear();
+      }
+    }
+  });
+  service.open(0, YCK_TCP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  service.open(1, YCK_TCP_CLIENT);
+
+  auto start = highp_clock();
+  while (received < FRAME_COUNT && highp_clock() - start < 20 * std::micro::den)
+  {
+    service.dispatch(1024);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  checks.clear();
+  service.stop();
+
+  printf("received frames: %d/%d, sliced: %d, errors: %d\n", received, FRAME_COUNT, sliced,
+         errors);
+  bool ok = received == FRAME_COUNT && sliced > 0 && errors == 0;
+  printf(ok ? "recv_slices test passed.\n" : "recv_slices test failed!\n");
+  return ok ? 0 : 1;
+}
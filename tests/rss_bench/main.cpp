@@ -0,0 +1,87 @@
+// The benchmark of memory cost per idle connection, the server and clients run at one
+// io_service, each connection exchange one small frame then keep idle.
+// usage: rss_bench [connections] [recv_buffer_size]
+#include <stdio.h>
+#include <stdlib.h>
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+using namespace yasio::inet;
+
+// Gets the resident set size in bytes, only linux supported
+static long long get_rss()
+{
+#if defined(__linux__)
+  long long pages = 0, resident = 0;
+  FILE* fp        = fopen("/proc/self/statm", "r");
+  if (fp)
+  {
+    if (fscanf(fp, "%lld %lld", &pages, &resident) != 2)
+      resident = 0;
+    fclose(fp);
+  }
+  return resident * sysconf(_SC_PAGESIZE);
+#else
+  return 0;
+#endif
+}
+
+int main(int argc, char** argv)
+{
+  int connections = argc > 1 ? atoi(argv[1]) : 1000;
+  int rbuf_size   = argc > 2 ? atoi(argv[2]) : YASIO_INET_BUFFER_SIZE;
+
+  std::vector<io_hostent> hosts(connections + 1, io_hostent{"127.0.0.1", 18198});
+  io_service service(&hosts.front(), static_cast<int>(hosts.size()));
+  for (int i = 0; i <= connections; ++i)
+  {
+    service.set_option(YOPT_C_LFBFD_PARAMS, i, 65536, 0, 4, 4);
+    service.set_option(YOPT_C_RECV_BUFFER_SIZE, i, rbuf_size);
+  }
+  service.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+  service.set_option(YOPT_S_TCP_BACKLOG, connections);
+
+  int connected = 0, echoed = 0;
+  service.start([&](event_ptr&& event) {
+    switch (event->kind())
+    {
+      case YEK_CONNECT_RESPONSE:
+        if (event->status() == 0 && event->cindex() != 0)
+        {
+          ++connected;
+          service.write(event->transport(), "\0\0\0\x4ping", 8);
+        }
+        break;
+      case YEK_PACKET:
+        if (event->cindex() == 0) // echo
+          service.write(event->transport(), event->packet().data(), event->packet().size());
+        else
+          ++echoed;
+        break;
+    }
+  });
+
+  service.open(0, YCK_TCP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  service.dispatch(128);
+  auto rss_before = get_rss();
+
+  for (int i = 1; i <= connections; ++i)
+    service.open(i, YCK_TCP_CLIENT);
+  auto start = highp_clock();
+  while (echoed < connections && highp_clock() - start < 30LL * std::micro::den)
+  {
+    service.dispatch(1024);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  auto rss_after = get_rss();
+
+  printf("connections: %d/%d, echoed: %d, recv buffer size: %d\n", connected, connections, echoed,
+         rbuf_size);
+  printf("rss: %lld KB --> %lld KB, per idle connection (2 transports): %.2f KB\n",
+         rss_before / 1024, rss_after / 1024,
+         connected ? (rss_after - rss_before) / 1024.0 / connected : 0.0);
+
+  service.stop();
+  return 0;
+}
@@ -0,0 +1,78 @@
+// The regression test of io_service_group, the connections accepted by the tcp server channel
+// of group should be sharded to multiple loops and echo at the loop which owns the transport.
+#include <stdio.h>
+#include <map>
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+using namespace yasio::inet;
+
+#define GROUP_CONCURRENCY 4
+#define CLIENT_COUNT 40
+
+int main()
+{
+  io_hostent server_host{"0.0.0.0", 19941};
+  io_service_group group(GROUP_CONCURRENCY, &server_host, 1);
+  group.set_option(YOPT_C_LFBFD_PARAMS, 0, 65536, -1, 0, 0);
+  group.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+
+  std::map<io_service*, int> accepted; // the accepted connections of each loop
+  group.start([&](event_ptr&& event) {
+    switch (event->kind())
+    {
+      case YEK_CONNECT_RESPONSE:
+        if (event->status() == 0)
+          ++accepted[&io_service_group::owner_of(event->transport())];
+        break;
+      case YEK_PACKET:
+        group.write(event->transport(), std::move(event->packet()));
+        break;
+    }
+  });
+  group.open(0, YCK_TCP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  std::vector<io_hostent> hosts(CLIENT_COUNT, io_hostent{"127.0.0.1", 19941});
+  io_service client(hosts.data(), CLIENT_COUNT);
+  for (int i = 0; i < CLIENT_COUNT; ++i)
+    client.set_option(YOPT_C_LFBFD_PARAMS, i, 65536, -1, 0, 0);
+
+  int echoed = 0;
+  client.start([&](event_ptr&& event) {
+    if (event->kind() == YEK_CONNECT_RESPONSE && event->status() == 0)
+      client.write(event->transport(), "ping", 4);
+    else if (event->kind() == YEK_PACKET && event->packet().size() == 4)
+      ++echoed;
+  });
+  for (int i = 0; i < CLIENT_COUNT; ++i)
+    client.open(i, YCK_TCP_CLIENT);
+
+  auto start = highp_clock();
+  while (echoed < CLIENT_COUNT && highp_clock() - start < 5 * std::micro::den)
+  {
+    group.dispatch();
+    client.dispatch();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  client.stop();
+  group.stop();
+
+  int total = 0;
+  for (auto& item : accepted)
+    total += item.second;
+  printf("accepted: %d, echoed: %d/%d, loops used: %d/%d\n", total, echoed, CLIENT_COUNT,
+         (int)accepted.size(), GROUP_CONCURRENCY);
+#if defined(SO_REUSEPORT)
+  bool sharded = accepted.size() > 1;
+#else
+  bool sharded = true;
+#endif
+  if (echoed != CLIENT_COUNT || total != CLIENT_COUNT || !sharded)
+  {
+    printf("service_group test failed!\n");
+    return 1;
+  }
+  printf("service_group test passed.\n");
+  return 0;
+}
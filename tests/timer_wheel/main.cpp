@@ -0,0 +1,139 @@
+// The regression test of timer wheel, verify the values expire exactly at due tick across the
+// level cascades, erase & reschedule, and the highp_timer scheduled by io_service.
+#include <stdio.h>
+#include <atomic>
+#include <map>
+#include <random>
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+using namespace yasio::inet;
+
+typedef timer_wheel<int> wheel_t;
+
+static int test_wheel()
+{
+  wheel_t wheel;
+  std::mt19937_64 rng(20201016);
+  wheel_t::tick_type now = 1600000000000ULL;
+  std::map<int, wheel_t::tick_type> due;
+  std::map<int, wheel_t::node*> nodes;
+  int id = 0, fired = 0, errors = 0;
+
+  // a single far timer, the next expiry shouldn't be the next cascade tick
+  auto far = wheel.insert(now, now + 3600 * 1000, 0);
+  if (wheel.next_expiry() != now + 3600 * 1000)
+    ++errors;
+  wheel.erase(far);
+
+  for (int round = 0; round < 200000; ++round)
+  {
+    int op = static_cast<int>(rng() % 10);
+    if (op < 4)
+    { // short or long (cross upper levels) timers
+      auto delay = (rng() % 4 == 0) ? rng() % (1ULL << 22) : rng() % 1000;
+      int key    = ++id;
+      due[key]   = now + delay;
+      nodes[key] = wheel.insert(now, now + delay, std::move(key));
+    }
+    else if (op < 6 && !nodes.empty())
+    { // erase or reschedule
+      auto it = nodes.begin();
+      std::advance(it, rng() % nodes.size());
+      if (op == 4)
+      {
+        wheel.erase(it->second);
+        due.erase(it->first);
+        nodes.erase(it);
+      }
+      else
+      {
+        due[it->first] = now + rng() % (1ULL << 16);
+        wheel.reschedule(it->second, due[it->first]);
+      }
+    }
+    else
+    {
+      if (!wheel.empty())
+      { // the next expiry is the earliest due tick
+        auto earliest = due.begin()->second;
+        for (auto& item : due)
+          earliest = (std::min)(earliest, item.second);
+        auto next = wheel.next_expiry();
+        if (next != earliest && !(earliest <= now && next <= now + 1))
+          ++errors;
+      }
+      now += 1 + ((rng() % 8 == 0) ? rng() % 100000 : rng() % 50);
+      wheel.expire(now, [&](int&& key) {
+        if (due[key] > now)
+          ++errors; // fired early
+        due.erase(key);
+        nodes.erase(key);
+        ++fired;
+      });
+      for (auto& item : due)
+        if (item.second <= now)
+        {
+          ++errors; // fired late
+          break;
+        }
+    }
+  }
+  if (due.size() != wheel.size())
+    ++errors;
+  printf("timer_wheel: fired: %d, remain: %d, errors: %d\n", fired, (int)wheel.size(), errors);
+  return errors;
+}
+
+static int test_service_timers()
+{
+  io_service service;
+  service.start([](event_ptr&&) {});
+
+  const int count = 200;
+  std::atomic<int> fired{0}, early{0}, cancelled_fired{0}, repeats{0};
+  std::vector<highp_timer_ptr> timers;
+  std::mt19937 rng(1016);
+  for (int i = 0; i < count; ++i)
+  { // cross the 256 ticks of level 0
+    auto delay    = std::chrono::milliseconds(1 + rng() % 600);
+    auto deadline = highp_clock() + delay.count() * 1000;
+    bool cancel   = i % 4 == 0;
+    timers.push_back(service.schedule(delay, [=, &fired, &early, &cancelled_fired]() {
+      if (highp_clock() < deadline)
+        ++early;
+      if (cancel)
+        ++cancelled_fired;
+      ++fired;
+      return true;
+    }));
+  }
+  for (int i = 0; i < count; i += 4)
+    timers[i]->cancel();
+
+  // the timer wait again 3 times
+  auto repeat = service.schedule(std::chrono::milliseconds(30), [&]() { return ++repeats >= 3; });
+
+  auto start = highp_clock();
+  while ((fired < count * 3 / 4 || repeats < 3) && highp_clock() - start < 3 * std::micro::den)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  service.stop();
+
+  printf("highp_timer: fired: %d/%d, early: %d, cancelled fired: %d, repeats: %d\n", fired.load(),
+         count * 3 / 4, early.load(), cancelled_fired.load(), repeats.load());
+  return (fired == count * 3 / 4 && early == 0 && cancelled_fired == 0 && repeats == 3) ? 0 : 1;
+}
+
+int main()
+{
+  int errors = test_wheel();
+  errors += test_service_timers();
+  if (errors != 0)
+  {
+    printf("timer_wheel test failed!\n");
+    return 1;
+  }
+  printf("timer_wheel test passed.\n");
+  return 0;
+}
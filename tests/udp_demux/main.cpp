@@ -0,0 +1,103 @@
+// The regression test of YCF_UDP_DEMUX, the udp server demultiplex the peers by one socket, every
+// peer should get one session and it's echoes, all sessions lost when server channel closed.
+#include <stdio.h>
+#include <atomic>
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+using namespace yasio::inet;
+
+#define CLIENT_COUNT 20
+#define MESSAGE_COUNT 200
+
+int main()
+{
+  std::vector<io_hostent> hosts(CLIENT_COUNT + 1, io_hostent{"127.0.0.1", 19951});
+  io_service service(hosts.data(), static_cast<int>(hosts.size()));
+
+  std::atomic<int> sessions{0}, lost{0}, echoed{0}, errors{0}, ready{0};
+  std::vector<transport_handle_t> clients(CLIENT_COUNT + 1);
+  service.start([&](event_ptr&& event) {
+    if (event->cindex() == 0)
+    { // server
+      switch (event->kind())
+      {
+        case YEK_CONNECT_RESPONSE:
+          ++sessions;
+          break;
+        case YEK_CONNECTION_LOST:
+          ++lost;
+          break;
+        case YEK_PACKET:
+          service.write(event->transport(), std::move(event->packet()));
+          break;
+      }
+    }
+    else
+    { // the message size & tag are the client index
+      if (event->kind() == YEK_CONNECT_RESPONSE && event->status() == 0)
+      {
+        clients[event->cindex()] = event->transport();
+        ++ready;
+      }
+      else if (event->kind() == YEK_PACKET)
+      {
+        auto& packet = event->packet();
+        if (packet.size() != static_cast<size_t>(8 + event->cindex()) ||
+            packet[7] != static_cast<char>(event->cindex()))
+          ++errors;
+        ++echoed;
+      }
+    }
+  });
+  service.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR | YCF_UDP_DEMUX, 0);
+  service.open(0, YCK_UDP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  for (int i = 1; i <= CLIENT_COUNT; ++i)
+    service.open(i, YCK_UDP_CLIENT);
+
+  auto start = highp_clock();
+  while (ready < CLIENT_COUNT && highp_clock() - start < 3 * std::micro::den)
+  {
+    service.dispatch();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  for (int n = 0; n < MESSAGE_COUNT && ready == CLIENT_COUNT; ++n)
+  {
+    for (int i = 1; i <= CLIENT_COUNT; ++i)
+    {
+      std::vector<char> message(8 + i);
+      message[7] = static_cast<char>(i);
+      service.write(clients[i], std::move(message));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  start = highp_clock();
+  while (echoed < CLIENT_COUNT * MESSAGE_COUNT && highp_clock() - start < 5 * std::micro::den)
+  {
+    service.dispatch(1024);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  // the demultiplexed sessions are closed with server channel
+  service.close(0);
+  start = highp_clock();
+  while (lost < CLIENT_COUNT && highp_clock() - start < 2 * std::micro::den)
+  {
+    service.dispatch();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  service.stop();
+
+  printf("sessions: %d, echoed: %d/%d, errors: %d, lost: %d\n", sessions.load(), echoed.load(),
+         CLIENT_COUNT * MESSAGE_COUNT, errors.load(), lost.load());
+  if (sessions != CLIENT_COUNT || echoed != CLIENT_COUNT * MESSAGE_COUNT || errors != 0 ||
+      lost != CLIENT_COUNT)
+  {
+    printf("udp_demux test failed!\n");
+    return 1;
+  }
+  printf("udp_demux test passed.\n");
+  return 0;
+}
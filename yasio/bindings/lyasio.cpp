@@ -164,7 +164,17 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
             service->set_option(opt, static_cast<int>(va[0]));
         }
       },
-      "dispatch", &io_service::dispatch, "open", &io_service::open, "is_open",
+      "dispatch", &io_service::dispatch, "dispatch_batch",
+      [](io_service* service, int count, sol::function fn) {
+        service->dispatch_batch(count, [&](event_ptr* events, int n) {
+          sol::state_view lua(fn.lua_state());
+          auto evs = lua.create_table(n, 0);
+          for (int i = 0; i < n; ++i)
+            evs[i + 1] = std::move(events[i]);
+          fn(evs);
+        });
+      },
+      "open", &io_service::open, "is_open",
       sol::overload(
           static_cast<bool (io_service::*)(int) const>(&io_service::is_open),
           static_cast<bool (io_service::*)(transport_handle_t) const>(&io_service::is_open)),
@@ -418,6 +428,15 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
                              })
           .addFunction("stop", &io_service::stop)
           .addFunction("dispatch", &io_service::dispatch)
+          .addStaticFunction("dispatch_batch",
+                             [](io_service* service, int count, kaguya::LuaFunction fn) {
+                               service->dispatch_batch(count, [&](event_ptr* events, int n) {
+                                 kaguya::LuaTable evs(fn.state(), kaguya::NewTable(n, 0));
+                                 for (int i = 0; i < n; ++i)
+                                   evs.setRawField(i + 1, events[i].get());
+                                 fn(evs);
+                               });
+                             })
           .addFunction("open", &io_service::open)
           .addOverloadedFunctions(
               "is_open", static_cast<bool (io_service::*)(int) const>(&io_service::is_open),
@@ -1309,6 +1309,46 @@ bool js_yasio_io_service_dispatch(se::State& s)
 }
 SE_BIND_FUNC(js_yasio_io_service_dispatch)
 
+bool js_yasio_io_service_dispatch_batch(se::State& s)
+{
+  auto cobj = (io_service*)s.nativeThisObject();
+  SE_PRECONDITION2(cobj, false, ": Invalid Native Object");
+  const auto& args = s.args();
+  size_t argc      = args.size();
+
+  do
+  {
+    if (argc == 2)
+    {
+      auto& jsFunc = args[1]; // cb with io_event array
+      CC_BREAK_IF(!jsFunc.isObject() || !jsFunc.toObject()->isFunction());
+
+      se::Value jsThis(s.thisObject());
+      cobj->dispatch_batch(args[0].toInt32(), [&](inet::event_ptr* events, int count) {
+        se::HandleObject jsEvents(se::Object::createArrayObject(count));
+        for (int i = 0; i < count; ++i)
+        {
+          se::Value jsEvent;
+          native_ptr_to_seval<io_event>(events[i].release(), &jsEvent);
+          jsEvents->setArrayElement(i, jsEvent);
+        }
+        se::ValueArray invokeArgs;
+        invokeArgs.push_back(se::Value(jsEvents));
+        bool succeed = jsFunc.toObject()->call(invokeArgs, jsThis.toObject());
+        if (!succeed)
+        {
+          se::ScriptEngine::getInstance()->clearException();
+        }
+      });
+      return true;
+    }
+  } while (false);
+
+  SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+  return false;
+}
+SE_BIND_FUNC(js_yasio_io_service_dispatch_batch)
+
 bool js_yasio_io_service_set_option(se::State& s)
 {
   auto service = (io_service*)s.nativeThisObject();
@@ -1477,6 +1517,7 @@ void js_register_yasio_io_service(se::Object* obj)
   DEFINE_IO_SERVICE_FUNC(close);
   DEFINE_IO_SERVICE_FUNC(is_open);
   DEFINE_IO_SERVICE_FUNC(dispatch);
+  DEFINE_IO_SERVICE_FUNC(dispatch_batch);
   DEFINE_IO_SERVICE_FUNC(write);
   DEFINE_IO_SERVICE_FUNC(write_to);
 
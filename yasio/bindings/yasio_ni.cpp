@@ -74,6 +74,16 @@ inline const char* svtoa(cxx17::string_view& sv) { return !sv.empty() ? sv.data(
 
 extern "C" {
 
+// The event passed by yasio_dispatch_batch, the fields same as the event_cb of yasio_start
+struct yasio_event_desc
+{
+  uint32_t emask;
+  int cidx;
+  intptr_t sid;
+  intptr_t bytes;
+  int len;
+};
+
 typedef int (*YASIO_PFNRESOLV)(const char* host, intptr_t sbuf);
 typedef void (*YASIO_PFNPRINT)(const char*);
 YASIO_NI_API void yasio_start(int channel_count,
@@ -188,6 +198,26 @@ YASIO_NI_API int yasio_write(intptr_t thandle, const unsigned char* bytes, int l
   return yasio_shared_service()->write(p, std::move(buf));
 }
 YASIO_NI_API void yasio_dispatch(int count) { yasio_shared_service()->dispatch(count); }
+YASIO_NI_API void yasio_dispatch_batch(int count,
+                                       void (*batch_cb)(const yasio_event_desc* events, int count))
+{
+  static std::vector<yasio_event_desc> s_descs; // only call at the thread who dispatch events
+  yasio_shared_service()->dispatch_batch(count, [=](event_ptr* events, int n) {
+    s_descs.resize(n);
+    for (int i = 0; i < n; ++i)
+    {
+      auto& e     = events[i];
+      auto packet = e->packet_view();
+      auto& desc  = s_descs[i];
+      desc.emask  = ((e->kind() << 16) & 0xffff0000) | (e->status() & 0xffff);
+      desc.cidx   = e->cindex();
+      desc.sid    = reinterpret_cast<intptr_t>(e->transport());
+      desc.bytes  = reinterpret_cast<intptr_t>(!packet.empty() ? packet.data() : nullptr);
+      desc.len    = static_cast<int>(packet.size());
+    }
+    batch_cb(s_descs.data(), n);
+  });
+}
 YASIO_NI_API void yasio_stop() { yasio_shared_service()->stop(); }
 YASIO_NI_API long long yasio_highp_time(void) { return highp_clock<system_clock_t>(); }
 YASIO_NI_API long long yasio_highp_clock(void) { return highp_clock<steady_clock_t>(); }
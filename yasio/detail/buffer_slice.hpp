@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// A cross platform socket APIs, support ios & android & wp8 & window store
+// universal app
+//////////////////////////////////////////////////////////////////////////////////////////
+/*
+The MIT License (MIT)
+
+Copyright (c) 2012-2020 HALX99
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef YASIO__BUFFER_SLICE_HPP
+#define YASIO__BUFFER_SLICE_HPP
+
+#include <stddef.h>
+#include <atomic>
+#include <utility>
+#include "yasio/detail/config.hpp"
+#include "yasio/detail/object_pool.hpp"
+
+namespace yasio
+{
+/* The reference counted receive block, allocate from concurrent object pool,
+   the frames received into it can be delivered as slices without copy.
+*/
+class buffer_block
+{
+public:
+  enum
+  {
+    capacity = YASIO_INET_BUFFER_SIZE
+  };
+
+  buffer_block() : refs_(1) {}
+
+  char* data() { return data_; }
+
+  // Whether no slice refer to this block, only the owner transport
+  bool unique() const { return refs_.load(std::memory_order_acquire) == 1; }
+
+  void retain() { refs_.fetch_add(1, std::memory_order_relaxed); }
+  void release()
+  {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      delete this;
+  }
+
+#if !defined(YASIO_DISABLE_OBJECT_POOL)
+  DEFINE_CONCURRENT_OBJECT_POOL_ALLOCATION(buffer_block, 32)
+#endif
+
+private:
+  std::atomic<int> refs_;
+  char data_[capacity];
+};
+
+/* The read only view of buffer_block, holds a reference of the block until destroyed.
+ */
+class buffer_slice
+{
+public:
+  buffer_slice() : block_(nullptr), data_(nullptr), size_(0) {}
+  buffer_slice(buffer_block* block, const char* data, size_t size)
+      : block_(block), data_(data), size_(size)
+  {
+    block_->retain();
+  }
+  buffer_slice(const buffer_slice& rhs) : block_(rhs.block_), data_(rhs.data_), size_(rhs.size_)
+  {
+    if (block_)
+      block_->retain();
+  }
+  buffer_slice(buffer_slice&& rhs) : block_(rhs.block_), data_(rhs.data_), size_(rhs.size_)
+  {
+    rhs.block_ = nullptr;
+    rhs.data_  = nullptr;
+    rhs.size_  = 0;
+  }
+  ~buffer_slice() { reset(); }
+
+  buffer_slice& operator=(buffer_slice rhs)
+  {
+    std::swap(block_, rhs.block_);
+    std::swap(data_, rhs.data_);
+    std::swap(size_, rhs.size_);
+    return *this;
+  }
+
+  void reset()
+  {
+    if (block_)
+    {
+      block_->release();
+      block_ = nullptr;
+    }
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+  explicit operator bool() const { return block_ != nullptr; }
+
+private:
+  buffer_block* block_;
+  const char* data_;
+  size_t size_;
+};
+} // namespace yasio
+
+#endif
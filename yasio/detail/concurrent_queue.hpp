@@ -29,11 +29,16 @@ SOFTWARE.
 #ifndef YASIO__CONCURRENT_QUEUE_HPP
 #define YASIO__CONCURRENT_QUEUE_HPP
 
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
 #include "yasio/detail/config.hpp"
 #if defined(YASIO_USE_SPSC_QUEUE)
 #  include "yasio/moodycamel/readerwriterqueue.h"
-#else
-#  include <queue>
 #endif
 
 namespace yasio
@@ -52,6 +57,11 @@ template <typename _T, bool _Dual> class concurrent_queue : public moodycamel::R
 {
 public:
   bool empty() const { return this->peek() == nullptr; }
+  template <typename _Iter> void emplace_bulk(_Iter first, _Iter last)
+  {
+    for (; first != last; ++first)
+      this->enqueue(std::move(*first));
+  }
   void consume(int count, const std::function<void(_T&&)>& func)
   {
     _T event;
@@ -106,6 +116,14 @@ public:
     queue_.emplace(std::forward<_Valty>(_Val)...);
   }
 
+  // Move the elements of range into queue with one lock
+  template <typename _Iter> void emplace_bulk(_Iter first, _Iter last)
+  {
+    std::lock_guard<std::recursive_mutex> lck(this->mtx_);
+    for (; first != last; ++first)
+      queue_.emplace(std::move(*first));
+  }
+
   void pop() { queue_.pop(); }
   bool empty() const { return this->queue_.empty(); }
   void clear() { clear_queue(this->queue_); }
@@ -154,6 +172,286 @@ private:
   std::queue<_T> deal_;
 };
 #endif
+
+// The intrusive node of mpsc_queue
+struct mpsc_node
+{
+  std::atomic<mpsc_node*> mpsc_next_{nullptr};
+};
+
+/*
+** The intrusive lock-free multi-producer single-consumer queue, see:
+** http://www.1024cores.net/home/lock-free-algorithms/queues/intrusive-mpsc-node-based-queue
+** Remark: The element must derive from mpsc_node, the queue owns the pushed elements.
+*/
+template <typename _T> class mpsc_queue
+{
+public:
+  mpsc_queue() : head_(&stub_), tail_(&stub_), front_(nullptr), back_(nullptr) {}
+  ~mpsc_queue() { clear(); }
+
+  // Push at any thread
+  void push(_T* item) { this->push_node(item); }
+
+  // Gets the front element without remove, only call at consumer thread.
+  _T* peek()
+  {
+    if (front_ == nullptr)
+      this->fetch();
+    return front_;
+  }
+
+  // Gets the element after item without remove, only call at consumer thread.
+  _T* next(_T* item)
+  {
+    auto n = item->mpsc_next_.load(std::memory_order_relaxed);
+    if (n == nullptr && item == back_)
+      n = this->fetch();
+    return static_cast<_T*>(n);
+  }
+
+  // Remove the front element and return it to caller, only call at consumer thread.
+  _T* pop()
+  {
+    auto item = this->peek();
+    if (item != nullptr)
+    {
+      front_ = static_cast<_T*>(item->mpsc_next_.load(std::memory_order_relaxed));
+      if (front_ == nullptr)
+        back_ = nullptr;
+    }
+    return item;
+  }
+
+  // Only call at consumer thread, may return true when a producer is pushing.
+  bool empty() { return this->peek() == nullptr; }
+
+  // Only call at consumer thread
+  void clear()
+  {
+    while (auto item = this->pop())
+      delete item;
+  }
+
+private:
+  void push_node(mpsc_node* n)
+  {
+    n->mpsc_next_.store(nullptr, std::memory_order_relaxed);
+    auto prev = head_.exchange(n, std::memory_order_acq_rel);
+    prev->mpsc_next_.store(n, std::memory_order_release);
+  }
+
+  // Take one element from producers and append it to consumer list: front_ ~ back_
+  mpsc_node* fetch()
+  {
+    auto n = this->take();
+    if (n != nullptr)
+    {
+      n->mpsc_next_.store(nullptr, std::memory_order_relaxed);
+      if (back_ != nullptr)
+        back_->mpsc_next_.store(n, std::memory_order_relaxed);
+      else
+        front_ = static_cast<_T*>(n);
+      back_ = static_cast<_T*>(n);
+    }
+    return n;
+  }
+
+  mpsc_node* take()
+  {
+    auto tail = tail_;
+    auto next = tail->mpsc_next_.load(std::memory_order_acquire);
+    if (tail == &stub_)
+    {
+      if (next == nullptr)
+        return nullptr;
+      tail_ = next;
+      tail  = next;
+      next  = next->mpsc_next_.load(std::memory_order_acquire);
+    }
+    if (next != nullptr)
+    {
+      tail_ = next;
+      return tail;
+    }
+    if (tail != head_.load(std::memory_order_acquire))
+      return nullptr; // a producer is pushing, the element will be available soon
+    this->push_node(&stub_);
+    next = tail->mpsc_next_.load(std::memory_order_acquire);
+    if (next != nullptr)
+    {
+      tail_ = next;
+      return tail;
+    }
+    return nullptr;
+  }
+
+  std::atomic<mpsc_node*> head_; // the producers push at head
+  mpsc_node* tail_;              // the consumer take from tail
+  mpsc_node stub_;
+  _T* front_; // the consumer list front, elements taken but not popped yet
+  _T* back_;
+};
+/*
+** The bounded lock-free multi-producer single-consumer ring, see:
+** http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+** Remark: When the ring full, the elements are pushed to a mutex protected overflow queue, and
+**         the elements pushed by one producer are always consumed in order.
+*/
+template <typename _T> class ring_queue
+{
+  enum
+  {
+    cacheline_size = 64,
+    max_spins      = 64,
+  };
+  struct cell
+  {
+    std::atomic<size_t> seq_;
+    _T value_;
+  };
+
+public:
+  // The capacity will be round up to power of 2
+  explicit ring_queue(size_t capacity) : cells_(round_up(capacity))
+  {
+    mask_ = cells_.size() - 1;
+    for (size_t i = 0; i < cells_.size(); ++i)
+      cells_[i].seq_.store(i, std::memory_order_relaxed);
+  }
+
+  // Push at any thread, never block by consumer unless the ring full.
+  template <typename _Valty> void emplace(_Valty&& value)
+  {
+    if (overflow_size_.load(std::memory_order_acquire) == 0 && this->try_push(value))
+      return;
+    std::lock_guard<std::mutex> lck(overflow_mtx_);
+    overflow_.emplace(std::forward<_Valty>(value));
+    overflow_size_.fetch_add(1, std::memory_order_release);
+  }
+
+  // Move the elements of range into queue, the overflow locked once at most.
+  template <typename _Iter> void emplace_bulk(_Iter first, _Iter last)
+  {
+    for (; first != last && overflow_size_.load(std::memory_order_acquire) == 0; ++first)
+      if (!this->try_push(*first))
+        break;
+    if (first == last)
+      return;
+    std::lock_guard<std::mutex> lck(overflow_mtx_);
+    int n = 0;
+    for (; first != last; ++first, ++n)
+      overflow_.emplace(std::move(*first));
+    overflow_size_.fetch_add(n, std::memory_order_release);
+  }
+
+  // Pop up to count elements to func, only call at consumer thread.
+  void consume(int count, const std::function<void(_T&&)>& func)
+  {
+    _T value;
+    while (count-- > 0 && this->try_pop(value))
+      func(std::move(value));
+  }
+
+  // Pop one element, only call at consumer thread.
+  bool try_pop(_T& value)
+  {
+    // the elements taken from overflow are older than the elements in ring
+    if (!deal_.empty())
+    {
+      value = std::move(deal_.front());
+      deal_.pop();
+      return true;
+    }
+    if (this->try_pop_ring(value))
+      return true;
+    if (overflow_size_.load(std::memory_order_acquire) == 0)
+      return false;
+    {
+      std::lock_guard<std::mutex> lck(overflow_mtx_);
+      // the elements claimed in ring are older than overflow, take overflow only when ring drained,
+      // a claimed cell is published by it's producer soon, spin briefly on it.
+      for (int spins = 0; head_ != tail_.load(std::memory_order_acquire); ++spins)
+      {
+        if (this->try_pop_ring(value))
+          return true;
+        if (spins == max_spins)
+          return false;
+        std::this_thread::yield();
+      }
+      std::swap(deal_, overflow_);
+      overflow_size_.store(0, std::memory_order_release);
+    }
+    return this->try_pop(value);
+  }
+
+  // Only call at consumer thread
+  void clear()
+  {
+    _T value;
+    while (this->try_pop(value))
+      value = _T{};
+  }
+
+private:
+  static size_t round_up(size_t capacity)
+  {
+    size_t n = 2;
+    while (n < capacity)
+      n <<= 1;
+    return n;
+  }
+
+  template <typename _Valty> bool try_push(_Valty& value)
+  {
+    auto pos = tail_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      auto& c  = cells_[pos & mask_];
+      auto seq = c.seq_.load(std::memory_order_acquire);
+      auto dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (dif == 0)
+      {
+        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          c.value_ = std::forward<_Valty>(value);
+          c.seq_.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (dif < 0)
+        return false; // full
+      else
+        pos = tail_.load(std::memory_order_relaxed);
+    }
+  }
+
+  bool try_pop_ring(_T& value)
+  {
+    auto& c  = cells_[head_ & mask_];
+    auto seq = c.seq_.load(std::memory_order_acquire);
+    if (seq != head_ + 1)
+      return false; // empty or producer is pushing
+    value = std::move(c.value_);
+    c.seq_.store(head_ + mask_ + 1, std::memory_order_release);
+    ++head_;
+    return true;
+  }
+
+  std::vector<cell> cells_;
+  size_t mask_;
+
+  char pad0_[cacheline_size];
+  std::atomic<size_t> tail_{0}; // producers
+  char pad1_[cacheline_size];
+  size_t head_ = 0; // consumer
+  char pad2_[cacheline_size];
+
+  std::atomic<int> overflow_size_{0};
+  std::mutex overflow_mtx_;
+  std::queue<_T> overflow_;
+  std::queue<_T> deal_; // the elements taken from overflow, only access at consumer thread
+};
 } // namespace concurrency
 } // namespace yasio
 
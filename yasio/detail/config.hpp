@@ -43,8 +43,8 @@ SOFTWARE.
 /*
 ** Uncomment or add compiler flag -DYASIO_USE_SPSC_QUEUE to use SPSC queue in io_service
 ** Remark: By default, yasio use std's queue + mutex to ensure thread safe, If you want
-**         more fast messege queue and only have one thread to call io_service write APIs,
-**         you may need uncomment it.
+**         more fast event queue and only have one thread to call io_service::dispatch,
+**         you may need uncomment it. The send queue is always lock-free mpsc queue.
 */
 // #define YASIO_USE_SPSC_QUEUE 1
 
@@ -84,6 +84,19 @@ SOFTWARE.
 */
 // #define YASIO_DISABLE_CONCURRENT_SINGLETON 1
 
+/*
+** Uncomment or add compiler flag -DYASIO_DISABLE_EPOLL to use select instead of epoll at linux
+** Remark: The select poller is limited by FD_SETSIZE(1024) and cost O(max_fd) per wakeup.
+*/
+// #define YASIO_DISABLE_EPOLL 1
+
+/*
+** Uncomment or add compiler flag -DYASIO_DISABLE_TIMER_WHEEL to use sorted vector to manage timers
+** Remark: The timer wheel schedule & cancel timer is O(1), but timers may fire at most
+**         YASIO_TIMER_WHEEL_TICK later, the sorted vector is O(n log n) and fire timers exactly.
+*/
+// #define YASIO_DISABLE_TIMER_WHEEL 1
+
 /*
 ** Workaround for 'vs2013 without full c++11 support', in the future, drop vs2013 support and
 ** follow 3 lines code will be removed
@@ -139,20 +152,49 @@ SOFTWARE.
 /*
 ** The macros used by io_service.
 */
-// The default max listen count of tcp server.
-#define YASIO_SOMAXCONN 19
+// The default max listen count of tcp server, can be changed by YOPT_S_TCP_BACKLOG
+#if !defined(YASIO_SOMAXCONN)
+#  define YASIO_SOMAXCONN 19
+#endif
+
+// The default max connections accepted by tcp server at one loop iteration.
+#define YASIO_ACCEPT_BUDGET 64
+
+// The default max bytes and frames received by one transport at one loop iteration.
+#define YASIO_READ_BUDGET (4 * YASIO_INET_BUFFER_SIZE)
+#define YASIO_READ_FRAME_BUDGET 256
+
+// The default max bytes sent by one transport at one loop iteration.
+#define YASIO_WRITE_BUDGET (16 * YASIO_INET_BUFFER_SIZE)
+
+// The default max datagrams received by udp server with one recvmmsg call, max: 64
+#define YASIO_DGRAM_RECV_BATCH 16
+
+// The default max size of each datagram received by recvmmsg, the slab of udp server channel is
+// YASIO_DGRAM_RECV_BATCH * YASIO_DGRAM_RECV_SIZE, it's large enough for any udp datagram, so
+// nothing is truncated unless a smaller size set by YOPT_S_DGRAM_RECV_BATCH.
+#define YASIO_DGRAM_RECV_SIZE YASIO_INET_BUFFER_SIZE
+
+// The max io_send_ops gathered by one system call of tcp transport.
+#define YASIO_MAX_GATHER_OPS 64
+
+// The default delay in milliseconds to start next connect attempt, recommended by RFC 8305.
+#define YASIO_CONNECT_ATTEMPT_DELAY 250
 
 // The max wait duration in macroseconds when io_service nothing to do.
 #define YASIO_MAX_WAIT_DURATION 5 * 60 * 1000 * 1000
 
-// The the min wait duration in macroseconds when kernel send buffer is full.
-#define YASIO_WOULDBLOCK_WAIT_DURATION 16667
+// The tick in microseconds of timer wheel.
+#define YASIO_TIMER_WHEEL_TICK 1000
 
 // The default ttl of multicast
 #define YASIO_DEFAULT_MULTICAST_TTL (int)128
 
 #define YASIO_INET_BUFFER_SIZE 65536
 
+// The max cached buffers of each size class of packet pool.
+#define YASIO_PACKET_POOL_DEPTH 128
+
 /* max pdu buffer length, avoid large memory allocation when application layer decode a huge length
  * field. */
 #define YASIO_MAX_PDU_BUFFER_SIZE static_cast<int>(1 * 1024 * 1024)
@@ -160,6 +202,17 @@ SOFTWARE.
 // The max Initial Bytes To Strip for length field based frame decode mechanism
 #define YASIO_MAX_IBTS 32
 
+// The resolver threads of io_service, perform the dns queries without c-ares.
+#define YASIO_DNS_RESOLVER_THREADS 2
+
+// The default max staleness in seconds of dns record after cache timeout, see
+// YOPT_S_DNS_MAX_STALENESS
+#define YASIO_DNS_MAX_STALENESS 300
+
+// The default age in percent of dns cache timeout to refresh the dns record at background, see
+// YOPT_S_DNS_PREFETCH_THRESHOLD
+#define YASIO_DNS_PREFETCH_THRESHOLD 90
+
 // The fallback name servers when c-ares can't get name servers from system config,
 // For Android 8 or later, will always use the fallback name servers, for detail,
 // please see:
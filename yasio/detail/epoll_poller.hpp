@@ -0,0 +1,222 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// A cross platform socket APIs, support ios & android & wp8 & window store
+// universal app
+//////////////////////////////////////////////////////////////////////////////////////////
+/*
+The MIT License (MIT)
+
+Copyright (c) 2012-2020 HALX99
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef YASIO__EPOLL_POLLER_HPP
+#define YASIO__EPOLL_POLLER_HPP
+
+#include <errno.h>
+#include <limits.h>
+#include <algorithm>
+#include <memory>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <vector>
+#include "yasio/xxsocket.hpp"
+#include "yasio/detail/select_poller.hpp"
+
+namespace yasio
+{
+namespace inet
+{
+/*
+** The linux epoll poller, level-triggered, cost O(ready) per wakeup.
+** Remark:
+**   a. When epoll_create1 fails (i.e. out of descriptors), fallback to select.
+**   b. The interest of descriptor is cached, it's cleared by unregister_descriptor, so the
+**      io_service always unregister a registered descriptor before close it.
+*/
+class epoll_poller
+{
+  struct descriptor_state
+  {
+    int events  = 0; // registered interest, YEM_XXX
+    int revents = 0; // ready events reported by last poll_io
+  };
+
+public:
+  epoll_poller() : epoll_fd_(::epoll_create1(EPOLL_CLOEXEC)), nready_(0), ready_events_(128)
+  {
+    if (epoll_fd_ == -1)
+    {
+      YASIO_LOG("epoll_create1 failed, ec=%d, fallback to select", errno);
+      fallback_.reset(new select_poller());
+    }
+  }
+  ~epoll_poller()
+  {
+    if (epoll_fd_ != -1)
+      ::close(epoll_fd_);
+  }
+
+  // Whether the epoll available, otherwise the select poller is used.
+  bool is_native() const { return !fallback_; }
+
+  void register_descriptor(const socket_native_type fd, int flags)
+  {
+    if (fallback_)
+      return fallback_->register_descriptor(fd, flags);
+
+    auto& state   = this->state_of(fd);
+    int oldevents = state.events;
+    state.events |= flags;
+    if (state.events == oldevents)
+      return;
+
+    epoll_event ev = {to_epoll_events(state.events), {0}};
+    ev.data.fd     = fd;
+    if (oldevents == 0)
+    {
+      if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) == -1 && errno == EEXIST)
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev); // the kernel watching it already
+    }
+    else if (::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev) == -1 && errno == ENOENT)
+    { // the descriptor was closed without unregister, the kernel removed it, so add it again
+      ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+    }
+  }
+
+  void unregister_descriptor(const socket_native_type fd, int flags)
+  {
+    if (fallback_)
+      return fallback_->unregister_descriptor(fd, flags);
+
+    if (fd < 0 || static_cast<size_t>(fd) >= states_.size())
+      return;
+
+    auto& state   = states_[fd];
+    int oldevents = state.events;
+    state.events &= ~flags;
+    state.revents &= ~flags;
+    if (state.events == oldevents)
+      return;
+
+    epoll_event ev = {to_epoll_events(state.events), {0}};
+    ev.data.fd     = fd;
+    ::epoll_ctl(epoll_fd_, state.events != 0 ? EPOLL_CTL_MOD : EPOLL_CTL_DEL, fd, &ev);
+  }
+
+  // Wait at most 'waitd_usec' microseconds, returns the number of ready descriptors or -1.
+  int poll_io(long long waitd_usec)
+  {
+    if (fallback_)
+      return fallback_->poll_io(waitd_usec);
+
+    // clear the readiness reported by last poll_io
+    for (int i = 0; i < nready_; ++i)
+      states_[ready_events_[i].data.fd].revents = 0;
+
+    // round up to milliseconds, avoid wakeup before the earliest timer expired.
+    long long waitd_msec = (waitd_usec + 999) / 1000;
+    nready_ = ::epoll_wait(epoll_fd_, ready_events_.data(), static_cast<int>(ready_events_.size()),
+                           static_cast<int>((std::min)(waitd_msec, (long long)INT_MAX)));
+    if (nready_ <= 0)
+    {
+      int retval = nready_;
+      nready_    = 0;
+      return retval;
+    }
+
+    for (int i = 0; i < nready_; ++i)
+    {
+      auto& ev    = ready_events_[i];
+      auto& state = states_[ev.data.fd];
+      if (ev.events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+        state.revents |= (state.events & YEM_POLLIN);
+      if (ev.events & (EPOLLOUT | EPOLLHUP | EPOLLERR))
+        state.revents |= (state.events & YEM_POLLOUT);
+      if (ev.events & EPOLLERR)
+        state.revents |= (state.events & YEM_POLLERR);
+    }
+
+    int retval = nready_;
+    if (nready_ == static_cast<int>(ready_events_.size()))
+    { // grow the events buffer for the next wait, so more descriptors can be reported once.
+      std::vector<epoll_event> events(ready_events_.size() * 2);
+      std::copy(ready_events_.begin(), ready_events_.end(), events.begin());
+      ready_events_.swap(events);
+    }
+    return retval;
+  }
+
+  // Gets the ready events of the descriptor reported by last poll_io
+  int is_ready(const socket_native_type fd, int flags) const
+  {
+    if (fallback_)
+      return fallback_->is_ready(fd, flags);
+    if (fd >= 0 && static_cast<size_t>(fd) < states_.size())
+      return states_[fd].revents & flags;
+    return 0;
+  }
+
+  // Visit the ready descriptors reported by last poll_io, func(fd, revents)
+  template <typename _Fty> void foreach_ready(const _Fty& func) const
+  {
+    if (fallback_)
+      return fallback_->foreach_ready(func);
+    for (int i = 0; i < nready_; ++i)
+    {
+      auto fd     = ready_events_[i].data.fd;
+      int revents = states_[fd].revents;
+      if (revents)
+        func(fd, revents);
+    }
+  }
+
+private:
+  descriptor_state& state_of(const socket_native_type fd)
+  {
+    if (static_cast<size_t>(fd) >= states_.size())
+      states_.resize((std::max)(static_cast<size_t>(fd) + 1, states_.size() * 2));
+    return states_[fd];
+  }
+
+  static uint32_t to_epoll_events(int flags)
+  {
+    uint32_t events = 0;
+    if (flags & YEM_POLLIN)
+      events |= EPOLLIN;
+    if (flags & YEM_POLLOUT)
+      events |= EPOLLOUT;
+    if (flags & YEM_POLLERR)
+      events |= EPOLLERR;
+    return events;
+  }
+
+  int epoll_fd_;
+  std::unique_ptr<select_poller> fallback_;
+
+  // the count of ready events reported by last poll_io
+  int nready_;
+  std::vector<epoll_event> ready_events_;
+
+  // indexed by descriptor
+  std::vector<descriptor_state> states_;
+};
+} // namespace inet
+} // namespace yasio
+
+#endif
@@ -33,12 +33,30 @@ SOFTWARE.
 
 #include <assert.h>
 #include <stdlib.h>
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <vector>
 #include "sz.hpp"
+#include "yasio/compiler/feature_test.hpp"
 
 #define OBJECT_POOL_DECL inline
 
+// The max cached elements of per thread magazine of concurrent object pool, 0 to disable
+#if !defined(YASIO_POOL_MAGAZINE_SIZE)
+#  if YASIO__HAS_FULL_CXX11
+#    define YASIO_POOL_MAGAZINE_SIZE 64
+#  else
+#    define YASIO_POOL_MAGAZINE_SIZE 0
+#  endif
+#endif
+
+// The max bytes cached by one magazine, the large elements use smaller magazine
+#define YASIO_POOL_MAGAZINE_BYTES 65536
+
+// The max concurrent object pools which can be cached by one thread
+#define YASIO_POOL_MAX_MAGAZINES 8
+
 #if defined(_MSC_VER)
 #  pragma warning(push)
 #  pragma warning(disable : 4200)
@@ -232,14 +250,182 @@ public:
                                                  ELEMENT_COUNT);                                   \
     return s_pool;                                                                                 \
   }
+
+#if YASIO_POOL_MAGAZINE_SIZE > 0
+// The per thread free list of concurrent object pool, exchange elements with the pool in bulk
+struct magazine
+{
+  unsigned int owner = 0; // the id of owner pool, 0: unused
+  void* head         = nullptr;
+  int count          = 0;
+
+  void push(void* ptr)
+  {
+    *reinterpret_cast<void**>(ptr) = head;
+    head                           = ptr;
+    ++count;
+  }
+  void* pop()
+  {
+    void* ptr = head;
+    head      = *reinterpret_cast<void**>(ptr);
+    --count;
+    return ptr;
+  }
+};
+
+class magazine_owner
+{
+public:
+  virtual ~magazine_owner() {}
+
+  // Return all elements of the magazine to pool
+  virtual void flush(magazine&) = 0;
+};
+
+// The alive concurrent pools, the magazines flush to their owner at thread exit
+class magazine_registry
+{
+public:
+  static magazine_registry& instance()
+  {
+    static magazine_registry s_registry;
+    return s_registry;
+  }
+
+  unsigned int add(magazine_owner* owner)
+  {
+    std::lock_guard<std::mutex> lck(mtx_);
+    owners_.push_back(std::make_pair(++seed_, owner));
+    return seed_;
+  }
+
+  // Remove the destroyed pool, the magazines of it cleared by their threads at next access
+  void remove(unsigned int id)
+  {
+    std::lock_guard<std::mutex> lck(mtx_);
+    for (auto it = owners_.begin(); it != owners_.end(); ++it)
+      if (it->first == id)
+      {
+        owners_.erase(it);
+        break;
+      }
+    removals_.fetch_add(1, std::memory_order_release);
+  }
+
+  // The count of removed pools, the thread compare it to check whether clear it's magazines
+  unsigned int removals() const { return removals_.load(std::memory_order_acquire); }
+
+  // Clear the magazines of the destroyed pools, the elements freed with the chunks of pool
+  void clear_removed(magazine* mags, int count)
+  {
+    std::lock_guard<std::mutex> lck(mtx_);
+    for (int i = 0; i < count; ++i)
+    {
+      auto& mag = mags[i];
+      if (mag.owner == 0)
+        continue;
+      auto it = owners_.begin();
+      while (it != owners_.end() && it->first != mag.owner)
+        ++it;
+      if (it == owners_.end())
+        mag = magazine{};
+    }
+  }
+
+  void flush(magazine& mag)
+  {
+    std::lock_guard<std::mutex> lck(mtx_);
+    for (auto& item : owners_)
+      if (item.first == mag.owner)
+      {
+        item.second->flush(mag);
+        break;
+      }
+    mag = magazine{}; // the owner destroyed, the elements freed with its chunks
+  }
+
+private:
+  std::mutex mtx_;
+  unsigned int seed_ = 0;
+  std::atomic<unsigned int> removals_{0};
+  std::vector<std::pair<unsigned int, magazine_owner*>> owners_;
+};
+
+// The magazines of current thread
+class magazine_rack
+{
+public:
+  ~magazine_rack()
+  {
+    for (auto& mag : mags_)
+      if (mag.owner != 0)
+        magazine_registry::instance().flush(mag);
+  }
+
+  static magazine_rack& local()
+  {
+    static thread_local magazine_rack s_rack;
+    return s_rack;
+  }
+
+  // Gets the magazine of pool, nullptr if the rack full
+  magazine* get(unsigned int owner)
+  {
+    auto& registry = magazine_registry::instance();
+    auto removals  = registry.removals();
+    if (removals_ != removals)
+    { // some pools destroyed, release the slots of them
+      removals_ = removals;
+      registry.clear_removed(mags_, YASIO_POOL_MAX_MAGAZINES);
+    }
+    magazine* avail = nullptr;
+    for (auto& mag : mags_)
+    {
+      if (mag.owner == owner)
+        return &mag;
+      if (avail == nullptr && mag.owner == 0)
+        avail = &mag;
+    }
+    if (avail != nullptr)
+      avail->owner = owner;
+    return avail;
+  }
+
+private:
+  magazine mags_[YASIO_POOL_MAX_MAGAZINES];
+  unsigned int removals_ = 0; // the removals of registry seen by this thread
+};
+#endif
 } // namespace detail
 
-template <typename _Ty, typename _Mutex = std::mutex> class object_pool : public detail::object_pool
+/*
+** The thread safe object pool, when YASIO_POOL_MAGAZINE_SIZE > 0, each thread caches elements
+** with a bounded local free list, only lock the pool when it's empty or full.
+*/
+template <typename _Ty, typename _Mutex = std::mutex>
+class object_pool : public detail::object_pool
+#if YASIO_POOL_MAGAZINE_SIZE > 0
+    , public detail::magazine_owner
+#endif
 {
 public:
   object_pool(size_t _ElemCount = 512)
       : detail::object_pool(YASIO_POOL_ESTIMATE_SIZE(_Ty), _ElemCount)
-  {}
+  {
+#if YASIO_POOL_MAGAZINE_SIZE > 0
+    mag_size_ = static_cast<int>(YASIO_POOL_MAGAZINE_BYTES / YASIO_POOL_ESTIMATE_SIZE(_Ty));
+    if (mag_size_ > YASIO_POOL_MAGAZINE_SIZE)
+      mag_size_ = YASIO_POOL_MAGAZINE_SIZE;
+    if (mag_size_ < 2)
+      mag_size_ = 2;
+    id_ = detail::magazine_registry::instance().add(this);
+#endif
+  }
+
+#if YASIO_POOL_MAGAZINE_SIZE > 0
+  ~object_pool() { detail::magazine_registry::instance().remove(id_); }
+#endif
 
   template <typename... _Args> _Ty* construct(const _Args&... args)
   {
@@ -249,22 +435,62 @@ public:
   void destroy(void* _Ptr)
   {
     ((_Ty*)_Ptr)->~_Ty(); // call the destructor
-    release(_Ptr);
+    deallocate(_Ptr);
   }
 
   void* allocate()
   {
+#if YASIO_POOL_MAGAZINE_SIZE > 0
+    auto mag = detail::magazine_rack::local().get(id_);
+    if (mag != nullptr)
+    {
+      if (mag->count == 0)
+      { // refill half of magazine
+        std::lock_guard<_Mutex> lk(this->mutex_);
+        for (int i = 0; i < mag_size_ / 2; ++i)
+          mag->push(get());
+      }
+      return mag->pop();
+    }
+#endif
     std::lock_guard<_Mutex> lk(this->mutex_);
     return get();
   }
 
   void deallocate(void* _Ptr)
   {
+#if YASIO_POOL_MAGAZINE_SIZE > 0
+    auto mag = detail::magazine_rack::local().get(id_);
+    if (mag != nullptr)
+    {
+      mag->push(_Ptr);
+      if (mag->count >= mag_size_)
+      { // return half of magazine
+        std::lock_guard<_Mutex> lk(this->mutex_);
+        while (mag->count > mag_size_ / 2)
+          release(mag->pop());
+      }
+      return;
+    }
+#endif
     std::lock_guard<_Mutex> lk(this->mutex_);
     release(_Ptr);
   }
 
   _Mutex mutex_;
+
+#if YASIO_POOL_MAGAZINE_SIZE > 0
+private:
+  void flush(detail::magazine& mag) override
+  {
+    std::lock_guard<_Mutex> lk(this->mutex_);
+    while (mag.count > 0)
+      release(mag.pop());
+  }
+
+  unsigned int id_;
+  int mag_size_; // the max elements of magazine
+#endif
 };
 
 template <typename _Ty> class object_pool<_Ty, void> : public detail::object_pool
@@ -0,0 +1,158 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// A cross platform socket APIs, support ios & android & wp8 & window store
+// universal app
+//////////////////////////////////////////////////////////////////////////////////////////
+/*
+The MIT License (MIT)
+
+Copyright (c) 2012-2020 HALX99
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef YASIO__PACKET_POOL_HPP
+#define YASIO__PACKET_POOL_HPP
+
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "yasio/detail/config.hpp"
+
+namespace yasio
+{
+struct packet_pool_stats
+{
+  unsigned long long hits     = 0; // acquired from pool
+  unsigned long long misses   = 0; // allocated from heap
+  unsigned long long recycled = 0; // returned to pool
+  unsigned long long dropped  = 0; // freed due to the size class full or too large
+
+  double hit_rate() const { return hits + misses ? static_cast<double>(hits) / (hits + misses) : 0; }
+};
+
+/* The size classed packet buffer pool, the classes are power of 2 from 64 bytes to 64K bytes,
+   each class caches at most YASIO_PACKET_POOL_DEPTH buffers, the larger buffers not pooled.
+*/
+class packet_pool
+{
+public:
+  enum
+  {
+    min_class_shift = 6,
+    max_class_shift = 16,
+    class_count     = max_class_shift - min_class_shift + 1,
+  };
+
+  static packet_pool& instance()
+  {
+    static packet_pool s_pool;
+    return s_pool;
+  }
+
+  // Acquire an empty packet buffer which capacity is at least size
+  std::vector<char> acquire(size_t size)
+  {
+    std::vector<char> packet;
+    int index = class_of(size);
+#if !defined(YASIO_DISABLE_OBJECT_POOL)
+    if (index < class_count)
+    {
+      auto& sc = classes_[index];
+      std::unique_lock<std::mutex> lck(sc.mtx_);
+      if (!sc.free_.empty())
+      {
+        packet = std::move(sc.free_.back());
+        sc.free_.pop_back();
+        lck.unlock();
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return packet;
+      }
+    }
+#endif
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    packet.reserve(index < class_count ? class_size(index) : size);
+    return packet;
+  }
+
+  // Return the packet buffer to pool, the packet is empty after this call
+  void recycle(std::vector<char>& packet)
+  {
+    auto capacity = packet.capacity();
+    if (capacity < class_size(0))
+      return;
+#if !defined(YASIO_DISABLE_OBJECT_POOL)
+    if (capacity <= class_size(class_count - 1))
+    { // the largest class not greater than capacity
+      int index = class_of(capacity);
+      if (class_size(index) > capacity)
+        --index;
+      auto& sc = classes_[index];
+      std::unique_lock<std::mutex> lck(sc.mtx_);
+      if (sc.free_.size() < YASIO_PACKET_POOL_DEPTH)
+      {
+        packet.clear();
+        sc.free_.push_back(std::move(packet));
+        lck.unlock();
+        recycled_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+    }
+#endif
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    std::vector<char>().swap(packet);
+  }
+
+  packet_pool_stats stats() const
+  {
+    packet_pool_stats st;
+    st.hits     = hits_.load(std::memory_order_relaxed);
+    st.misses   = misses_.load(std::memory_order_relaxed);
+    st.recycled = recycled_.load(std::memory_order_relaxed);
+    st.dropped  = dropped_.load(std::memory_order_relaxed);
+    return st;
+  }
+
+private:
+  static size_t class_size(int index) { return static_cast<size_t>(1) << (index + min_class_shift); }
+
+  // The smallest class which can hold size, class_count if too large
+  static int class_of(size_t size)
+  {
+    int index = 0;
+    while (index < class_count && class_size(index) < size)
+      ++index;
+    return index;
+  }
+
+  struct size_class
+  {
+    std::mutex mtx_;
+    std::vector<std::vector<char>> free_;
+  };
+  size_class classes_[class_count];
+
+  std::atomic<unsigned long long> hits_{0};
+  std::atomic<unsigned long long> misses_{0};
+  std::atomic<unsigned long long> recycled_{0};
+  std::atomic<unsigned long long> dropped_{0};
+};
+} // namespace yasio
+
+#endif
@@ -0,0 +1,134 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// A cross platform socket APIs, support ios & android & wp8 & window store
+// universal app
+//////////////////////////////////////////////////////////////////////////////////////////
+/*
+The MIT License (MIT)
+
+Copyright (c) 2012-2020 HALX99
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef YASIO__SELECT_POLLER_HPP
+#define YASIO__SELECT_POLLER_HPP
+
+#include <string.h>
+#include "yasio/xxsocket.hpp"
+
+namespace yasio
+{
+namespace inet
+{
+// The portable poller, cost O(max_fd) per wakeup and limited by FD_SETSIZE.
+class select_poller
+{
+public:
+  select_poller() : max_nfds_(0)
+  {
+    FD_ZERO(&fds_array_[read_op]);
+    FD_ZERO(&fds_array_[write_op]);
+    FD_ZERO(&fds_array_[except_op]);
+    ::memcpy(ready_fds_array_, fds_array_, sizeof(fds_array_));
+  }
+
+  void register_descriptor(const socket_native_type fd, int flags)
+  {
+    if ((flags & YEM_POLLIN) != 0)
+      FD_SET(fd, &(fds_array_[read_op]));
+
+    if ((flags & YEM_POLLOUT) != 0)
+      FD_SET(fd, &(fds_array_[write_op]));
+
+    if ((flags & YEM_POLLERR) != 0)
+      FD_SET(fd, &(fds_array_[except_op]));
+
+    if (max_nfds_ < static_cast<int>(fd) + 1)
+      max_nfds_ = static_cast<int>(fd) + 1;
+  }
+
+  void unregister_descriptor(const socket_native_type fd, int flags)
+  {
+    if ((flags & YEM_POLLIN) != 0)
+      FD_CLR(fd, &(fds_array_[read_op]));
+
+    if ((flags & YEM_POLLOUT) != 0)
+      FD_CLR(fd, &(fds_array_[write_op]));
+
+    if ((flags & YEM_POLLERR) != 0)
+      FD_CLR(fd, &(fds_array_[except_op]));
+  }
+
+  // Wait at most 'waitd_usec' microseconds, returns the number of ready descriptors or -1.
+  int poll_io(long long waitd_usec)
+  {
+    ::memcpy(ready_fds_array_, fds_array_, sizeof(fds_array_));
+    timeval waitd_tv = {(decltype(timeval::tv_sec))(waitd_usec / 1000000),
+                        (decltype(timeval::tv_usec))(waitd_usec % 1000000)};
+    return ::select(this->max_nfds_, &(ready_fds_array_[read_op]), &(ready_fds_array_[write_op]),
+                    nullptr, &waitd_tv);
+  }
+
+  // Gets the ready events of the descriptor reported by last poll_io
+  int is_ready(const socket_native_type fd, int flags) const
+  {
+    int revents = 0;
+    if ((flags & YEM_POLLIN) && FD_ISSET(fd, &(ready_fds_array_[read_op])))
+      revents |= YEM_POLLIN;
+    if ((flags & YEM_POLLOUT) && FD_ISSET(fd, &(ready_fds_array_[write_op])))
+      revents |= YEM_POLLOUT;
+    return revents;
+  }
+
+  // Visit the ready descriptors reported by last poll_io, func(fd, revents)
+  template <typename _Fty> void foreach_ready(const _Fty& func) const
+  {
+#if defined(_WIN32)
+    // winsock fd_set is a socket array, visit it directly
+    for (u_int i = 0; i < ready_fds_array_[read_op].fd_count; ++i)
+      func(ready_fds_array_[read_op].fd_array[i], YEM_POLLIN);
+    for (u_int i = 0; i < ready_fds_array_[write_op].fd_count; ++i)
+      func(ready_fds_array_[write_op].fd_array[i], YEM_POLLOUT);
+#else
+    for (int fd = 0; fd < max_nfds_; ++fd)
+    {
+      int revents = is_ready(fd, YEM_POLLIN | YEM_POLLOUT);
+      if (revents)
+        func(fd, revents);
+    }
+#endif
+  }
+
+private:
+  enum
+  {
+    read_op,
+    write_op,
+    except_op,
+    max_ops,
+  };
+  fd_set fds_array_[max_ops];
+  fd_set ready_fds_array_[max_ops];
+
+  // the max nfds for socket.select, must be max_fd + 1
+  int max_nfds_;
+};
+} // namespace inet
+} // namespace yasio
+
+#endif
@@ -0,0 +1,309 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// A cross platform socket APIs, support ios & android & wp8 & window store
+// universal app
+//////////////////////////////////////////////////////////////////////////////////////////
+/*
+The MIT License (MIT)
+
+Copyright (c) 2012-2020 HALX99
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef YASIO__TIMER_WHEEL_HPP
+#define YASIO__TIMER_WHEEL_HPP
+
+#include <stddef.h>
+#include <utility>
+
+namespace yasio
+{
+/*
+** The hashed hierarchical timing wheel, same layout as the classic linux kernel timers:
+** level 0 has 256 slots, level 1~4 has 64 slots, covers 2^32 ticks, the insert & erase are O(1).
+** Remark: not thread safe, the owner should lock it when access by multi threads.
+*/
+template <typename _Ty> class timer_wheel
+{
+  enum
+  {
+    root_bits  = 8,
+    level_bits = 6,
+    max_levels = 4,
+    root_size  = 1 << root_bits,
+    level_size = 1 << level_bits,
+    root_mask  = root_size - 1,
+    level_mask = level_size - 1,
+  };
+
+  struct link
+  {
+    link* prev;
+    link* next;
+    void init() { prev = next = this; }
+    bool empty() const { return next == this; }
+  };
+
+public:
+  typedef unsigned long long tick_type;
+
+  struct node : public link
+  {
+    tick_type expires = 0;
+    _Ty value;
+  };
+
+  timer_wheel()
+  {
+    for (auto& slot : root_)
+      slot.init();
+    for (auto& level : levels_)
+      for (auto& slot : level)
+        slot.init();
+  }
+  ~timer_wheel()
+  {
+    this->clear([](_Ty&) {});
+    while (free_ != nullptr)
+    {
+      auto n = free_;
+      free_  = static_cast<node*>(n->next);
+      delete n;
+    }
+  }
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  // Insert a value expires at tick, the expired value will be expired at next expire call.
+  node* insert(tick_type now, tick_type expires, _Ty&& value)
+  {
+    if (size_ == 0 && next_tick_ < now) // skip the idle ticks
+      next_tick_ = now;
+
+    node* n = free_;
+    if (n != nullptr)
+      free_ = static_cast<node*>(n->next);
+    else
+      n = new node();
+    n->expires = expires;
+    n->value   = std::move(value);
+    this->link_node(n);
+    ++size_;
+    if (expiry_valid_ && n->expires < expiry_)
+      expiry_ = n->expires;
+    return n;
+  }
+
+  // Move the node to new expires tick
+  void reschedule(node* n, tick_type expires)
+  {
+    unlink_node(n);
+    this->invalidate_expiry(n);
+    n->expires = expires;
+    this->link_node(n);
+    if (expiry_valid_ && n->expires < expiry_)
+      expiry_ = n->expires;
+  }
+
+  void erase(node* n)
+  {
+    unlink_node(n);
+    this->invalidate_expiry(n);
+    --size_;
+    this->release(n);
+  }
+
+  // Expire the values due at or before tick 'now', func(_Ty&&) is allowed to insert or erase.
+  template <typename _Fty> void expire(tick_type now, const _Fty& func)
+  {
+    while (next_tick_ <= now)
+    {
+      if (size_ == 0)
+      { // nothing to do, skip the idle ticks
+        next_tick_ = now + 1;
+        break;
+      }
+
+      auto index = static_cast<int>(next_tick_ & root_mask);
+      if (index == 0)
+      { // cascade the upper levels when level 0 wrap
+        for (int level = 0; level < max_levels && this->cascade(level) == 0; ++level)
+          ;
+      }
+      ++next_tick_;
+
+      auto& slot = root_[index];
+      while (!slot.empty())
+      {
+        auto n = static_cast<node*>(slot.next);
+        unlink_node(n);
+        --size_;
+        this->invalidate_expiry(n);
+        _Ty value = std::move(n->value);
+        this->release(n);
+        func(std::move(value));
+      }
+    }
+  }
+
+  // Gets the earliest tick need to call expire, the wheel must not be empty.
+  tick_type next_expiry() const
+  {
+    if (!expiry_valid_)
+    {
+      expiry_       = this->earliest_expires();
+      expiry_valid_ = true;
+    }
+    return expiry_;
+  }
+
+  // Clear all values, func(_Ty&) is called before value destroyed.
+  template <typename _Fty> void clear(const _Fty& func)
+  {
+    auto clear_slot = [&](link& slot) {
+      while (!slot.empty())
+      {
+        auto n = static_cast<node*>(slot.next);
+        unlink_node(n);
+        func(n->value);
+        this->release(n);
+      }
+    };
+    for (auto& slot : root_)
+      clear_slot(slot);
+    for (auto& level : levels_)
+      for (auto& slot : level)
+        clear_slot(slot);
+    size_         = 0;
+    expiry_valid_ = false;
+  }
+
+private:
+  void link_node(node* n)
+  {
+    auto expires = n->expires;
+    auto delta   = expires - next_tick_;
+    link* slot;
+    if (expires < next_tick_) // expired already, expire at next tick
+      slot = &root_[next_tick_ & root_mask];
+    else if (delta < root_size)
+      slot = &root_[expires & root_mask];
+    else
+    {
+      int level = 0;
+      for (; level < max_levels - 1; ++level)
+        if (delta < (tick_type)1 << (root_bits + (level + 1) * level_bits))
+          break;
+      if (level == max_levels - 1 && delta > 0xffffffffULL)
+      { // out of range, clamp to max
+        expires    = next_tick_ + 0xffffffffULL;
+        n->expires = expires;
+      }
+      slot = &levels_[level][(expires >> (root_bits + level * level_bits)) & level_mask];
+    }
+
+    // append to tail of slot
+    n->next          = slot;
+    n->prev          = slot->prev;
+    slot->prev->next = n;
+    slot->prev       = n;
+  }
+
+  static void unlink_node(link* n)
+  {
+    n->prev->next = n->next;
+    n->next->prev = n->prev;
+    n->prev = n->next = nullptr;
+  }
+
+  // The earliest expires of all values, the cascade doesn't change it, so it's cached until the
+  // earliest value erased or expired.
+  tick_type earliest_expires() const
+  {
+    // the root slots hold the values expire in next root_size ticks exactly
+    tick_type earliest = ~static_cast<tick_type>(0);
+    for (tick_type tick = next_tick_; tick < next_tick_ + root_size; ++tick)
+    {
+      if (!root_[tick & root_mask].empty())
+      {
+        earliest = tick;
+        break;
+      }
+    }
+
+    // the first not cascaded slot of each level, it's values expire at or after the slot start
+    for (int level = 0; level < max_levels; ++level)
+    {
+      int shift       = root_bits + level * level_bits;
+      tick_type block = (next_tick_ + ((tick_type)1 << shift) - 1) >> shift;
+      for (int i = 0; i < level_size && (block << shift) < earliest; ++i, ++block)
+      {
+        auto& slot = levels_[level][block & level_mask];
+        if (slot.empty())
+          continue;
+        for (auto l = slot.next; l != &slot; l = l->next)
+          if (static_cast<const node*>(l)->expires < earliest)
+            earliest = static_cast<const node*>(l)->expires;
+        break;
+      }
+    }
+    return earliest;
+  }
+
+  void invalidate_expiry(const node* n)
+  {
+    if (n->expires <= expiry_)
+      expiry_valid_ = false;
+  }
+
+  // Move the slot of level to lower levels, returns the slot index.
+  int cascade(int level)
+  {
+    int index = static_cast<int>((next_tick_ >> (root_bits + level * level_bits)) & level_mask);
+    auto& slot = levels_[level][index];
+    while (!slot.empty())
+    {
+      auto n = static_cast<node*>(slot.next);
+      unlink_node(n);
+      this->link_node(n);
+    }
+    return index;
+  }
+
+  void release(node* n)
+  {
+    n->value = _Ty();
+    n->next  = free_;
+    free_    = n;
+  }
+
+  link root_[root_size];
+  link levels_[max_levels][level_size];
+
+  tick_type next_tick_ = 0; // the next tick to expire
+  size_t size_         = 0;
+
+  mutable tick_type expiry_   = 0; // the cached earliest expires, see next_expiry
+  mutable bool expiry_valid_ = false;
+
+  node* free_ = nullptr; // the free nodes for reuse
+};
+} // namespace yasio
+
+#endif
@@ -960,12 +960,19 @@ int xxsocket::listen(int backlog) const { return ::listen(this->fd, backlog); }
 
 xxsocket xxsocket::accept(socklen_t) { return ::accept(this->fd, nullptr, nullptr); }
 
-int xxsocket::accept_n(socket_native_type& new_sock)
+int xxsocket::accept_n(socket_native_type& new_sock, bool nonblocking)
 {
   for (;;)
   {
     // Accept the waiting connection.
+#if defined(__linux__) && (!defined(__ANDROID__) || __ANDROID_API__ >= 21)
+    new_sock = ::accept4(this->fd, nullptr, nullptr,
+                         nonblocking ? (SOCK_NONBLOCK | SOCK_CLOEXEC) : SOCK_CLOEXEC);
+#else
     new_sock = ::accept(this->fd, nullptr, nullptr);
+    if (new_sock != invalid_socket && nonblocking)
+      xxsocket::set_nonblocking(new_sock, true);
+#endif
 
     // Check if operation succeeded.
     if (new_sock != invalid_socket)
@@ -1188,6 +1195,27 @@ int xxsocket::send(socket_native_type s, const void* buf, int len, int flags)
   return static_cast<int>(::send(s, (const char*)buf, len, flags));
 }
 
+int xxsocket::sendv(const io_vec* bufs, int count, int flags) const
+{
+  return xxsocket::sendv(this->fd, bufs, count, flags);
+}
+
+int xxsocket::sendv(socket_native_type s, const io_vec* bufs, int count, int flags)
+{
+#if defined(_WIN32)
+  DWORD bytes_transferred = 0;
+  int ret = ::WSASend(s, const_cast<LPWSABUF>(bufs), static_cast<DWORD>(count), &bytes_transferred,
+                      static_cast<DWORD>(flags), nullptr, nullptr);
+  return ret == 0 ? static_cast<int>(bytes_transferred) : -1;
+#else
+  msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov    = const_cast<io_vec*>(bufs);
+  msg.msg_iovlen = count;
+  return static_cast<int>(::sendmsg(s, &msg, flags));
+#endif
+}
+
 int xxsocket::recv(void* buf, int len, int flags) const
 {
   return static_cast<int>(this->recv(this->fd, buf, len, flags));
@@ -74,6 +74,7 @@ typedef int socklen_t;
 #  endif
 #  include <sys/select.h>
 #  include <sys/socket.h>
+#  include <sys/uio.h>
 #  include <netinet/in.h>
 #  include <netinet/tcp.h>
 #  include <net/if.h>
@@ -536,6 +537,28 @@ YASIO__NS_INLINE namespace ip
     sockaddr_in6 in6_;
   };
 
+  // The hash & equal functors for unordered containers keyed by endpoint
+  struct endpoint_hash
+  {
+    size_t operator()(const endpoint& ep) const
+    { // FNV-1a
+      auto p   = reinterpret_cast<const unsigned char*>(&ep);
+      auto n   = ep.af() == AF_INET6 ? sizeof(ep.in6_) : sizeof(ep.in4_);
+      size_t h = 2166136261U;
+      for (size_t i = 0; i < n; ++i)
+        h = (h ^ p[i]) * 16777619U;
+      return h;
+    }
+  };
+  struct endpoint_equal
+  {
+    bool operator()(const endpoint& lhs, const endpoint& rhs) const
+    {
+      return lhs.af() == rhs.af() &&
+             ::memcmp(&lhs, &rhs, lhs.af() == AF_INET6 ? sizeof(lhs.in6_) : sizeof(lhs.in4_)) == 0;
+    }
+  };
+
   // supported internet protocol flags
   enum : u_short
   {
@@ -550,6 +573,23 @@ YASIO__NS_INLINE namespace ip
 using namespace yasio::inet::ip;
 #endif
 
+// The buffer descriptor for gather write, WSABUF at win32, iovec at other platforms
+#if defined(_WIN32)
+typedef WSABUF io_vec;
+inline void set_io_vec(io_vec& v, const void* base, size_t len)
+{
+  v.buf = (CHAR*)base;
+  v.len = static_cast<ULONG>(len);
+}
+#else
+typedef struct iovec io_vec;
+inline void set_io_vec(io_vec& v, const void* base, size_t len)
+{
+  v.iov_base = (void*)base;
+  v.iov_len  = len;
+}
+#endif
+
 /*
 ** CLASS xxsocket: a posix socket wrapper
 */
@@ -686,11 +726,12 @@ public:
 
   /* @brief: Permits an incoming connection attempt on this socket
   ** @params:
+  **        nonblocking: Whether make the new_sock non-blocking, use accept4 when available
   ** @returns:
   **        If no error occurs, return 0, and the new_sock will be the actual connection is made.
   **        Otherwise, a EWOULDBLOCK,EAGAIN or other value is returned
   */
-  YASIO__DECL int accept_n(socket_native_type& new_sock);
+  YASIO__DECL int accept_n(socket_native_type& new_sock, bool nonblocking = false);
 
   /* @brief: Establishes a connection to a specified this socket
   ** @params:
@@ -765,6 +806,17 @@ public:
   YASIO__DECL int send(const void* buf, int len, int flags = 0) const;
   YASIO__DECL static int send(socket_native_type fd, const void* buf, int len, int flags = 0);
 
+  /* @brief: Sends data of multi buffers on this connected socket with one system call
+  ** @params: omit
+  **
+  ** @returns:
+  **         If no error occurs, returns the total number of bytes sent, which can be
+  **         less than the total length of buffers. Otherwise, a value of SOCKET_ERROR is returned.
+  */
+  YASIO__DECL int sendv(const io_vec* bufs, int count, int flags = 0) const;
+  YASIO__DECL static int sendv(socket_native_type fd, const io_vec* bufs, int count,
+                               int flags = 0);
+
   /* @brief: Receives data from this connected socket or a bound connectionless socket.
   ** @params: omit
   **
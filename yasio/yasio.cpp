@@ -47,6 +47,21 @@ SOFTWARE.
 #include <sys/stat.h>
 #include <fcntl.h>
 
+// Whether sendmmsg & recvmmsg available
+#if defined(__linux__) && (!defined(__ANDROID_API__) || __ANDROID_API__ >= 21)
+#  include <netinet/udp.h>
+#  define YASIO__HAS_MMSG 1
+#  if !defined(UDP_SEGMENT)
+#    define UDP_SEGMENT 103
+#  endif
+// The max segments & payload of one GSO datagram, see linux/udp.h: UDP_MAX_SEGMENTS
+#  define YASIO__MAX_GSO_SEGMENTS 64
+#  define YASIO__MAX_GSO_PAYLOAD 65507
+#  define YASIO__MAX_DGRAM_RECV_BATCH 64
+#else
+#  define YASIO__HAS_MMSG 0
+#endif
+
 #if defined(YASIO_HAVE_SSL)
 #  include <openssl/bio.h>
 #  include <openssl/ssl.h>
@@ -106,14 +121,6 @@ namespace inet
 {
 namespace
 {
-// event mask
-enum
-{
-  YEM_POLLIN  = 1,
-  YEM_POLLOUT = 2,
-  YEM_POLLERR = 4,
-};
-
 // op mask
 enum
 {
@@ -225,6 +232,19 @@ public:
   static int s_max_alloc_size;
 };
 int yasio__global_state::s_max_alloc_size;
+
+// The builtin resolve by the ip stack version of localhost, not depends on io_service
+int yasio__builtin_resolv(std::vector<ip::endpoint>& endpoints, const char* hostname,
+                          unsigned short port, u_short ipsv)
+{
+  if (ipsv & ipsv_ipv4)
+    return xxsocket::resolve_v4(endpoints, hostname, port);
+  else if (ipsv & ipsv_ipv6) // localhost is IPv6_only network
+    return xxsocket::resolve_v6(endpoints, hostname, port) != 0
+               ? xxsocket::resolve_v4to6(endpoints, hostname, port)
+               : 0;
+  return -1;
+}
 } // namespace
 
 /// highp_timer
@@ -262,7 +282,8 @@ void ssl_auto_handle::destroy()
 #endif
 
 /// io_channel
-io_channel::io_channel(io_service& service, int index) : timer_(service)
+io_channel::io_channel(io_service& service, int index)
+    : timer_(service), attempt_timer_(service)
 {
   socket_            = std::make_shared<xxsocket>();
   state_             = io_base::state::CLOSED;
@@ -396,17 +417,60 @@ io_transport::io_transport(io_channel* ctx, std::shared_ptr<xxsocket>& s) : ctx_
   this->id_                       = ++s_object_id;
   this->socket_                   = s;
   this->ud_.ptr                   = nullptr;
+  this->buffer_size_              = ctx->rbuf_size_;
+  if (ctx->properties_ & YCF_RECV_SLICES)
+    this->block_ = new buffer_block();
 }
 int io_transport::write(std::vector<char>&& buffer, std::function<void()>&& handler)
 {
   int n = static_cast<int>(buffer.size());
-  send_queue_.emplace(cxx17::make_unique<io_send_op>(std::move(buffer), std::move(handler)));
-  ctx_->get_service().interrupt();
+  send_queue_.push(new io_send_op(std::move(buffer), std::move(handler)));
+  ctx_->get_service().activate(this);
   return n;
 }
 int io_transport::do_read(int& error)
 {
-  return this->call_read(buffer_ + wpos_, sizeof(buffer_) - wpos_, error);
+  int capacity = this->prepare_recv_buffer();
+  return this->call_read(recv_buffer() + wpos_, capacity - wpos_, error);
+}
+char* io_transport::recv_buffer()
+{
+  if (block_)
+    return block_->data();
+  return !is_shared_rbuf() ? buffer_.get() : &ctx_->get_service().shared_rbuf_.front();
+}
+int io_transport::prepare_recv_buffer()
+{
+  if (block_)
+    return buffer_block::capacity;
+  if (!is_shared_rbuf())
+  { // lazy allocate private buffer, uninitialized to keep untouched pages not resident
+    if (!buffer_)
+      reserve_recv_buffer(buffer_size_);
+    return buffer_capacity_;
+  }
+  auto& shared = ctx_->get_service().shared_rbuf_;
+  if (shared.empty())
+    shared.resize(YASIO_INET_BUFFER_SIZE);
+  if (wpos_ > 0)
+    ::memcpy(&shared.front(), buffer_.get(), wpos_);
+  return static_cast<int>(shared.size());
+}
+void io_transport::hold_recv_data(const char* data, int size)
+{
+  wpos_ = size;
+  if (size > 0)
+  {
+    if (buffer_capacity_ < size)
+      reserve_recv_buffer((std::max)(size, buffer_size_));
+    if (data != buffer_.get())
+      ::memmove(buffer_.get(), data, size);
+  }
+}
+void io_transport::reserve_recv_buffer(int capacity)
+{
+  buffer_.reset(new char[capacity]);
+  buffer_capacity_ = capacity;
 }
 bool io_transport::do_write(long long& max_wait_duration)
 {
@@ -416,23 +480,56 @@ bool io_transport::do_write(long long& max_wait_duration)
     if (!socket_->is_open())
       break;
 
+    /* flush the ops of stream until the kernel buffer full, the budget ensure fairness between
+       transports, the remain ops will be sent at next loop iteration. The datagrams are sent with
+       one batch per loop iteration, because the kernel buffer of udp never full, flush them
+       in a burst only cause the peer drop them. */
+    auto& service   = ctx_->get_service();
+    auto budget_end = bytes_sent_ + service.options_.write_budget_;
+    bool stream     = !!(ctx_->properties_ & YCM_TCP);
     int error = 0, internal_ec = 0;
-    auto wrap = send_queue_.peek();
-    if (wrap)
+    for (io_send_op* op; (op = send_queue_.peek()) != nullptr;)
     {
-      auto& v = *wrap;
-      if (call_write(v.get(), error, internal_ec))
-        send_queue_.pop();
-      else if (error != 0)
+      auto bytes_sent = bytes_sent_;
+      bool gathered   = send_queue_.next(op) && call_writev(op, error, internal_ec);
+      if (!gathered && call_write(op, error, internal_ec))
+        delete send_queue_.pop();
+      if (!stream || error != 0 || internal_ec != 0 || bytes_sent_ == bytes_sent)
+        break;
+      if (bytes_sent_ >= budget_end)
       {
-        set_last_errno(error);
+        ++service.stats_.write_budget_exhausted;
         break;
       }
     }
+    if (error != 0)
+    {
+      set_last_errno(error);
+      break;
+    }
 
-    // If still have work to do.
+    // If still have work to do, continue at next loop, or wait writable when kernel buffer full.
     if (!send_queue_.empty())
-      max_wait_duration = internal_ec != EWOULDBLOCK ? 0 : YASIO_WOULDBLOCK_WAIT_DURATION;
+    {
+      if (internal_ec != EWOULDBLOCK)
+        max_wait_duration = 0;
+      else if (!pollout_registered_)
+      {
+        pollout_registered_ = true;
+        if (is_shared_socket()) // the server socket writable is shared by sessions
+          service.wait_dgram_writable(this);
+        else
+          service.register_descriptor(socket_->native_handle(), YEM_POLLOUT);
+      }
+    }
+    else if (pollout_registered_)
+    {
+      pollout_registered_ = false;
+      if (is_shared_socket())
+        service.cancel_dgram_writable(this);
+      else
+        service.unregister_descriptor(socket_->native_handle(), YEM_POLLOUT);
+    }
 
     ret = true;
   } while (false);
@@ -464,6 +561,7 @@ bool io_transport::call_write(io_send_op* op, int& error, int& internal_ec)
   if (n > 0)
   {
     // #performance: change offset only, remain data will be send at next frame.
+    bytes_sent_ += n;
     op->offset_ += n;
     if (op->offset_ == op->buffer_.size())
     { // finished
@@ -471,6 +569,8 @@ bool io_transport::call_write(io_send_op* op, int& error, int& internal_ec)
         op->handler_();
       return true;
     }
+    // partial write, the kernel send buffer is full
+    internal_ec = EWOULDBLOCK;
   }
   else if (n < 0)
   {
@@ -480,6 +580,52 @@ bool io_transport::call_write(io_send_op* op, int& error, int& internal_ec)
   }
   return false;
 }
+bool io_transport::call_writev(io_send_op* op, int& error, int& internal_ec)
+{
+  if (!writev_cb_)
+    return false;
+
+  io_vec bufs[YASIO_MAX_GATHER_OPS];
+  int count   = 0;
+  size_t size = 0;
+  for (; op && count < YASIO_MAX_GATHER_OPS; op = send_queue_.next(op))
+  {
+    auto len = op->buffer_.size() - op->offset_;
+    if (count > 0 && len > static_cast<size_t>((std::numeric_limits<int>::max)()) - size)
+      break;
+    set_io_vec(bufs[count++], op->buffer_.data() + op->offset_, len);
+    size += len;
+  }
+
+  int n = writev_cb_(bufs, count);
+  if (n > 0)
+  {
+    bytes_sent_ += n;
+    // complete the ops by bytes transferred, the last one may be sent partially
+    size_t bytes_left = static_cast<size_t>(n);
+    while (bytes_left > 0)
+    {
+      op       = send_queue_.peek();
+      auto len = (std::min)(op->buffer_.size() - op->offset_, bytes_left);
+      op->offset_ += len;
+      bytes_left -= len;
+      if (op->offset_ < op->buffer_.size())
+        break;
+      if (op->handler_)
+        op->handler_();
+      delete send_queue_.pop();
+    }
+    if (static_cast<size_t>(n) < size) // the kernel send buffer is full
+      internal_ec = EWOULDBLOCK;
+  }
+  else if (n < 0)
+  {
+    internal_ec = xxsocket::get_last_errno();
+    if (YASIO_SHOULD_CLOSE_1(internal_ec))
+      error = internal_ec;
+  }
+  return true;
+}
 void io_transport::set_primitives()
 {
   this->write_cb_ = [=](const void* data, int len) { return socket_->send(data, len); };
@@ -489,6 +635,11 @@ void io_transport::set_primitives()
 inline io_transport_tcp::io_transport_tcp(io_channel* ctx, std::shared_ptr<xxsocket>& s)
     : io_transport(ctx, s)
 {}
+void io_transport_tcp::set_primitives()
+{
+  io_transport::set_primitives();
+  this->writev_cb_ = [=](const io_vec* bufs, int count) { return socket_->sendv(bufs, count); };
+}
 // ----------------------- io_transport_ssl ----------------
 #if defined(YASIO_HAVE_SSL)
 io_transport_ssl::io_transport_ssl(io_channel* ctx, std::shared_ptr<xxsocket>& s)
@@ -504,7 +655,7 @@ void io_transport_ssl::set_primitives()
 #endif
 // ----------------------- io_transport_udp ----------------
 io_transport_udp::io_transport_udp(io_channel* ctx, std::shared_ptr<xxsocket>& s)
-    : io_transport(ctx, s)
+    : io_transport(ctx, s), gso_(!!(ctx->properties_ & YCF_UDP_GSO))
 {}
 io_transport_udp::~io_transport_udp() {}
 ip::endpoint io_transport_udp::peer_endpoint() const
@@ -535,6 +686,8 @@ int io_transport_udp::connect()
 {
   if (connected_)
     return 0;
+  if (is_shared_socket()) // the server socket can't establish 4 tuple with one peer
+    return -1;
 
   if (this->peer_.af() == AF_UNSPEC)
   {
@@ -560,14 +713,125 @@ int io_transport_udp::write_to(std::vector<char>&& buffer, const ip::endpoint& t
                                std::function<void()>&& handler)
 {
   int n = static_cast<int>(buffer.size());
-  send_queue_.emplace(cxx17::make_unique<io_sendto_op>(std::move(buffer), std::move(handler), to));
-  ctx_->get_service().interrupt();
+  send_queue_.push(new io_sendto_op(std::move(buffer), std::move(handler), to));
+  ctx_->get_service().activate(this);
   return n;
 }
+#if YASIO__HAS_MMSG
+bool io_transport_udp::call_writev(io_send_op* op, int& error, int& internal_ec)
+{
+  mmsghdr msgs[YASIO_MAX_GATHER_OPS];
+  io_vec bufs[YASIO_MAX_GATHER_OPS];
+  int segs[YASIO_MAX_GATHER_OPS]; // the ops count of each message
+  char controls[YASIO_MAX_GATHER_OPS][CMSG_SPACE(sizeof(uint16_t))];
+
+  int count = 0, nbufs = 0;
+  size_t payload = 0; // the payload of last message
+  const ip::endpoint* last_dest = nullptr;
+  for (; op && nbufs < YASIO_MAX_GATHER_OPS; op = send_queue_.next(op))
+  {
+    auto dest = op->destination();
+    auto len  = op->buffer_.size() - op->offset_;
+    if (gso_ && count > 0 && len > 0 && segs[count - 1] < YASIO__MAX_GSO_SEGMENTS &&
+        payload + len <= YASIO__MAX_GSO_PAYLOAD)
+    { // coalesce to last message: the segments are same size except the last one
+      auto& last = msgs[count - 1].msg_hdr;
+      auto seg   = bufs[nbufs - segs[count - 1]].iov_len;
+      bool same_dest =
+          dest == last_dest || (dest && last_dest && ::memcmp(dest, last_dest, sizeof(*dest)) == 0);
+      if (same_dest && len <= seg && bufs[nbufs - 1].iov_len == seg)
+      {
+        set_io_vec(bufs[nbufs++], op->buffer_.data() + op->offset_, len);
+        ++last.msg_iovlen;
+        ++segs[count - 1];
+        payload += len;
+        continue;
+      }
+    }
+
+    auto& msg = msgs[count].msg_hdr;
+    ::memset(&msgs[count], 0, sizeof(msgs[count]));
+    if (dest)
+    {
+      msg.msg_name    = (void*)&dest->sa_;
+      msg.msg_namelen = dest->af() == AF_INET6 ? sizeof(dest->in6_) : sizeof(dest->in4_);
+    }
+    msg.msg_iov = &bufs[nbufs];
+    set_io_vec(bufs[nbufs++], op->buffer_.data() + op->offset_, len);
+    msg.msg_iovlen = 1;
+    segs[count++]  = 1;
+    payload        = len;
+    last_dest      = dest;
+  }
+
+  // attach the segment size to the coalesced messages
+  for (int i = 0; i < count; ++i)
+  {
+    if (segs[i] < 2)
+      continue;
+    auto& msg          = msgs[i].msg_hdr;
+    msg.msg_control    = controls[i];
+    msg.msg_controllen = sizeof(controls[i]);
+    auto cm            = CMSG_FIRSTHDR(&msg);
+    cm->cmsg_level     = SOL_UDP;
+    cm->cmsg_type      = UDP_SEGMENT;
+    cm->cmsg_len       = CMSG_LEN(sizeof(uint16_t));
+    uint16_t seg       = static_cast<uint16_t>(msg.msg_iov[0].iov_len);
+    ::memcpy(CMSG_DATA(cm), &seg, sizeof(seg));
+  }
+
+  int n = ::sendmmsg(socket_->native_handle(), msgs, count, 0);
+  if (n > 0)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      bytes_sent_ += msgs[i].msg_len;
+      for (int k = 0; k < segs[i]; ++k)
+      {
+        op = send_queue_.pop();
+        if (op->handler_)
+          op->handler_();
+        delete op;
+      }
+    }
+    if (n < count) // the kernel send buffer is full or error occurred at message n
+      internal_ec = EWOULDBLOCK;
+  }
+  else if (n < 0)
+  {
+    internal_ec = xxsocket::get_last_errno();
+    if (segs[0] > 1 && (internal_ec == EIO || internal_ec == EINVAL || internal_ec == ENOPROTOOPT ||
+                        internal_ec == EOPNOTSUPP))
+    { // GSO unsupported by kernel or device, send without segmentation next time
+      gso_        = false;
+      internal_ec = 0;
+    }
+    else if (YASIO_SHOULD_CLOSE_1(internal_ec))
+      error = internal_ec;
+  }
+  return true;
+}
+#else
+bool io_transport_udp::call_writev(io_send_op*, int&, int&) { return false; }
+#endif
 void io_transport_udp::set_primitives()
 {
   if (connected_)
     io_transport::set_primitives();
+  else if (is_shared_socket())
+  { // the datagrams are received by server channel, see io_service::handle_dgram
+    this->write_cb_ = [=](const void* data, int len) {
+      return socket_->sendto(data, len, ensure_peer());
+    };
+    this->read_cb_ = [=](void* data, int len) {
+      int n = (std::min)(len, dgram_size_);
+      if (n > 0)
+        ::memcpy(data, dgram_, n);
+      dgram_      = nullptr;
+      dgram_size_ = 0;
+      return n;
+    };
+  }
   else
   {
     this->write_cb_ = [=](const void* data, int len) {
@@ -601,18 +865,19 @@ int io_transport_kcp::write(std::vector<char>&& buffer, std::function<void()>&&
 {
   std::lock_guard<std::recursive_mutex> lck(send_mtx_);
   int retval = ::ikcp_send(kcp_, buffer.data(), static_cast<int>(buffer.size()));
-  ctx_->get_service().interrupt();
+  ctx_->get_service().activate(this);
   return retval;
 }
 int io_transport_kcp::do_read(int& error)
 {
   char sbuf[YASIO_INET_BUFFER_SIZE];
-  int n = this->call_read(sbuf, sizeof(sbuf), error);
+  int capacity = this->prepare_recv_buffer();
+  int n        = this->call_read(sbuf, sizeof(sbuf), error);
   if (n > 0)
   { // ikcp in event always in service thread, so no need to lock
     if (0 == ::ikcp_input(kcp_, sbuf, n))
     {
-      n = ::ikcp_recv(kcp_, buffer_ + wpos_, sizeof(buffer_) - wpos_);
+      n = ::ikcp_recv(kcp_, recv_buffer() + wpos_, capacity - wpos_);
       if (n < 0) // EAGAIN/EWOULDBLOCK
         n = 0;
     }
@@ -718,15 +983,9 @@ void io_service::init(const io_hostent* channel_eps, int channel_count)
   if (channel_count <= 0)
     return;
 
-  FD_ZERO(&fds_array_[read_op]);
-  FD_ZERO(&fds_array_[write_op]);
-  FD_ZERO(&fds_array_[except_op]);
-
-  this->max_nfds_ = 0;
-
-  options_.resolv_ = [=](std::vector<ip::endpoint>& eps, const char* host, unsigned short port) {
-    return this->builtin_resolv(eps, host, port);
-  };
+#if !defined(YASIO_HAVE_CARES)
+  dns_ = std::make_shared<dns_state>();
+#endif
 
   register_descriptor(interrupter_.read_descriptor(), YEM_POLLIN);
 
@@ -739,9 +998,21 @@ void io_service::cleanup()
 {
   if (this->state_ == io_service::state::IDLE)
   {
+#if !defined(YASIO_HAVE_CARES)
+    stop_resolvers();
+#endif
     clear_channels();
     this->events_.clear();
+    if (this->event_ring_)
+      this->event_ring_->clear();
+#if !defined(YASIO_DISABLE_TIMER_WHEEL)
+    this->timer_wheel_.clear([](timer_impl_t&) {});
+#else
     this->timer_queue_.clear();
+#endif
+#if !defined(YASIO_HAVE_CARES)
+    dns_refresh_scheduled_ = false;
+#endif
 
     unregister_descriptor(interrupter_.read_descriptor(), YEM_POLLIN);
 
@@ -773,6 +1044,7 @@ void io_service::clear_channels()
   for (auto channel : channels_)
   {
     channel->timer_.cancel();
+    close_connect_attempts(channel);
     cleanup_io(channel);
     delete channel;
   }
@@ -782,16 +1054,47 @@ void io_service::clear_transports()
 {
   for (auto transport : transports_)
   {
-    cleanup_io(transport);
+    if (transport->is_shared_socket()) // the server socket is closed by channel
+      transport->ctx_->dgram_sessions_.clear();
+    else
+      cleanup_io(transport);
     transport->~io_transport();
     this->tpool_.push_back(transport);
   }
   transports_.clear();
+  transport_map_.clear();
+  active_transports_.clear();
+  activated_transports_.clear();
+  for (auto ctx : dgram_writable_channels_)
+    ctx->dgram_writers_.clear();
+  dgram_writable_channels_.clear();
 }
 void io_service::dispatch(int count)
 {
   if (options_.on_event_)
-    this->events_.consume(count, options_.on_event_);
+  {
+    if (!event_ring_)
+      this->events_.consume(count, options_.on_event_);
+    else
+      this->event_ring_->consume(count, options_.on_event_);
+  }
+}
+void io_service::dispatch_batch(int count, const io_event_batch_cb_t& cb)
+{
+  // take the storage, so the callback can call dispatch_batch again
+  std::vector<event_ptr> batch;
+  std::swap(batch, this->batch_events_);
+  io_event_cb_t collect = [&batch](event_ptr&& event) { batch.push_back(std::move(event)); };
+  if (!event_ring_)
+    this->events_.consume(count, collect);
+  else
+    this->event_ring_->consume(count, collect);
+  if (!batch.empty())
+  {
+    cb(batch.data(), static_cast<int>(batch.size()));
+    batch.clear();
+  }
+  std::swap(batch, this->batch_events_);
 }
 void io_service::run()
 {
@@ -809,11 +1112,10 @@ void io_service::run()
   this->ipsv_ = static_cast<u_short>(xxsocket::getipsv());
 
   // event loop
-  fd_set fds_array[max_ops];
   long long max_wait_duration = YASIO_MAX_WAIT_DURATION;
   for (; this->state_ == io_service::state::RUNNING;)
   {
-    int retval = do_select(fds_array, max_wait_duration);
+    int retval = do_poll(max_wait_duration);
     if (this->state_ != io_service::state::RUNNING)
       break;
 
@@ -822,32 +1124,33 @@ void io_service::run()
     if (retval == -1)
     {
       int ec = xxsocket::get_last_errno();
-      YASIO_SLOG("do_select failed, ec=%d, detail:%s\n", ec, io_service::strerror(ec));
+      YASIO_SLOG("do_poll failed, ec=%d, detail:%s\n", ec, io_service::strerror(ec));
       if (ec == EBADF)
         goto _L_end;
       continue; // just continue.
     }
 
     if (retval == 0)
-      YASIO_SLOGV("%s", "do_select is timeout, process_timers()");
+      YASIO_SLOGV("%s", "do_poll is timeout, process_timers()");
 
     // Reset the interrupter.
-    else if (retval > 0 && FD_ISSET(this->interrupter_.read_descriptor(), &(fds_array[read_op])))
+    else if (retval > 0 && poller_.is_ready(this->interrupter_.read_descriptor(), YEM_POLLIN))
     {
       interrupter_.reset();
+      wakeup_pending_.exchange(false);
       --retval;
     }
 
 #if defined(YASIO_HAVE_CARES)
     // process possible async resolve requests.
-    process_ares_requests(fds_array);
+    process_ares_requests();
 #endif
 
     // process active transports
-    process_transports(fds_array, max_wait_duration);
+    process_transports(max_wait_duration);
 
     // process active channels
-    process_channels(fds_array);
+    process_channels();
 
     // process timeout timers
     process_timers();
@@ -863,20 +1166,72 @@ _L_end:
   cleanup_ssl_context();
 #endif
 }
-void io_service::process_transports(fd_set* fds_array, long long& max_wait_duration)
+void io_service::process_transports(long long& max_wait_duration)
 {
-  // preform transports
-  for (auto iter = transports_.begin(); iter != transports_.end();)
+  // collect the transports which socket is ready
+  poller_.foreach_ready([this](socket_native_type fd, int) {
+    auto it = this->transport_map_.find(fd);
+    if (it != this->transport_map_.end())
+      this->activate_internal(it->second);
+  });
+
+  // collect the transports activated by write or close request
   {
-    auto transport = *iter;
-    if (do_read(transport, fds_array, max_wait_duration) && do_write(transport, max_wait_duration))
-      ++iter;
+    std::lock_guard<std::recursive_mutex> lck(this->activated_mtx_);
+    for (auto transport : this->activated_transports_)
+    {
+      if (!transport) // deallocated before collect
+        continue;
+      transport->activated_.exchange(false);
+      activate_internal(transport);
+    }
+    this->activated_transports_.clear();
+  }
+
+  // collect the transports of client channels which request close or reopen
+  if (!this->channel_ops_.empty())
+  {
+    std::lock_guard<std::recursive_mutex> lck(this->channel_ops_mtx_);
+    for (auto ctx : this->channel_ops_)
+    {
+      if ((ctx->properties_ & YCM_CLIENT) && (ctx->opmask_ & YOPM_CLOSE_TRANSPORT))
+      { // the connected socket of client channel always mapped to it's transport
+        auto it = this->transport_map_.find(ctx->socket_->native_handle());
+        if (it != this->transport_map_.end() && it->second->ctx_ == ctx)
+          activate_internal(it->second);
+      }
+    }
+  }
+
+  if (!this->dgram_writable_channels_.empty())
+    process_dgram_writable();
+
+  // preform active transports, keep the transports which still have work to do at next loop
+  size_t nactive = 0;
+  for (size_t i = 0; i < active_transports_.size(); ++i)
+  {
+    auto transport          = active_transports_[i];
+    long long wait_duration = YASIO_MAX_WAIT_DURATION;
+    if (do_read(transport, wait_duration) && do_write(transport, wait_duration))
+    {
+      if (wait_duration < YASIO_MAX_WAIT_DURATION)
+        active_transports_[nactive++] = transport;
+      else
+        transport->active_ = false;
+      if (max_wait_duration > wait_duration)
+        max_wait_duration = wait_duration;
+    }
     else
     {
+      auto slot = transport->slot_;
       handle_close(transport);
-      iter = transports_.erase(iter);
+      // swap and pop, the order of transports_ is insignificant
+      transports_[slot]        = transports_.back();
+      transports_[slot]->slot_ = slot;
+      transports_.pop_back();
     }
   }
+  active_transports_.resize(nactive);
 
   /*
     Because Bind() the client socket to the socket address of the listening socket.  On Linux this
@@ -904,7 +1259,7 @@ void io_service::process_transports(fd_set* fds_array, long long& max_wait_durat
   }
 #endif
 }
-void io_service::process_channels(fd_set* fds_array)
+void io_service::process_channels()
 {
   if (!this->channel_ops_.empty())
   {
@@ -930,7 +1285,7 @@ void io_service::process_channels(fd_set* fds_array)
           }
         }
         else if (ctx->state_ == io_base::state::OPENING)
-          do_nonblocking_connect_completion(ctx, fds_array);
+          do_nonblocking_connect_completion(ctx);
 
         finish = ctx->error_ != EINPROGRESS && (ctx->opmask_ & YOPM_OPEN_CHANNEL) == 0;
       }
@@ -938,14 +1293,23 @@ void io_service::process_channels(fd_set* fds_array)
       {
         auto opmask = ctx->opmask_;
         if (opmask & YOPM_CLOSE_CHANNEL)
+        {
+          // the demultiplexed udp sessions will be closed at process_transports
+          for (auto& session : ctx->dgram_sessions_)
+          {
+            session.second->opmask_ |= YOPM_CLOSE_TRANSPORT;
+            this->activate(session.second);
+          }
+          cancel_dgram_writable(ctx);
           cleanup_io(ctx);
+        }
 
         if (opmask & YOPM_OPEN_CHANNEL)
           do_nonblocking_accept(ctx);
 
         finish = (ctx->state_ != io_base::state::OPEN);
         if (!finish)
-          do_nonblocking_accept_completion(ctx, fds_array);
+          do_nonblocking_accept_completion(ctx);
       }
 
       if (finish)
@@ -965,7 +1329,17 @@ void io_service::close(int cindex)
   if (!(channel->opmask_ & YOPM_CLOSE_CHANNEL))
   {
     if (close_internal(channel))
+    {
+      if (channel->properties_ & YCM_CLIENT)
+      { // the transport of client channel will be activated by channel ops
+        this->channel_ops_mtx_.lock();
+        if (std::find(this->channel_ops_.begin(), this->channel_ops_.end(), channel) ==
+            this->channel_ops_.end())
+          this->channel_ops_.push_back(channel);
+        this->channel_ops_mtx_.unlock();
+      }
       this->interrupt();
+    }
   }
 }
 void io_service::close(transport_handle_t transport)
@@ -975,7 +1349,7 @@ void io_service::close(transport_handle_t transport)
     transport->opmask_ |= YOPM_CLOSE_TRANSPORT;
     if (transport->ctx_->properties_ & YCM_TCP)
       transport->socket_->shutdown();
-    this->interrupt();
+    this->activate(transport);
   }
 }
 bool io_service::is_open(transport_handle_t transport) const { return transport->is_open(); }
@@ -1020,7 +1394,17 @@ void io_service::handle_close(transport_handle_t thandle)
   YASIO_SLOG("[index: %d] the connection #%u is lost, ec=%d, detail:%s", ctx->index_, thandle->id_,
              ec, io_service::strerror(ec));
 
-  cleanup_io(thandle, false);
+  if (thandle->is_shared_socket())
+  { // don't close the server socket, the session isn't in descriptor map
+    if (thandle->pollout_registered_)
+      cancel_dgram_writable(thandle);
+    auto transport = static_cast<io_transport_udp*>(thandle);
+    auto it        = ctx->dgram_sessions_.find(transport->peer_);
+    if (it != ctx->dgram_sessions_.end() && it->second == thandle)
+      ctx->dgram_sessions_.erase(it);
+  }
+  else // remove from descriptor map by cleanup_io, or by the channel which closed the socket
+    cleanup_io(thandle, false);
 
   deallocate_transport(thandle);
 
@@ -1038,28 +1422,11 @@ void io_service::handle_close(transport_handle_t thandle)
 }
 void io_service::register_descriptor(const socket_native_type fd, int flags)
 {
-  if ((flags & YEM_POLLIN) != 0)
-    FD_SET(fd, &(fds_array_[read_op]));
-
-  if ((flags & YEM_POLLOUT) != 0)
-    FD_SET(fd, &(fds_array_[write_op]));
-
-  if ((flags & YEM_POLLERR) != 0)
-    FD_SET(fd, &(fds_array_[except_op]));
-
-  if (max_nfds_ < static_cast<int>(fd) + 1)
-    max_nfds_ = static_cast<int>(fd) + 1;
+  poller_.register_descriptor(fd, flags);
 }
 void io_service::unregister_descriptor(const socket_native_type fd, int flags)
 {
-  if ((flags & YEM_POLLIN) != 0)
-    FD_CLR(fd, &(fds_array_[read_op]));
-
-  if ((flags & YEM_POLLOUT) != 0)
-    FD_CLR(fd, &(fds_array_[write_op]));
-
-  if ((flags & YEM_POLLERR) != 0)
-    FD_CLR(fd, &(fds_array_[except_op]));
+  poller_.unregister_descriptor(fd, flags);
 }
 int io_service::write(transport_handle_t transport, std::vector<char> buffer,
                       std::function<void()> completion_handler)
@@ -1095,10 +1462,28 @@ int io_service::write_to(transport_handle_t transport, std::vector<char> buffer,
 void io_service::handle_event(event_ptr event)
 {
   if (options_.deferred_event_)
-    events_.emplace(std::move(event));
+  {
+    if (batching_events_)
+      pending_events_.push_back(std::move(event));
+    else if (!event_ring_)
+      events_.emplace(std::move(event));
+    else
+      event_ring_->emplace(std::move(event));
+  }
   else
     options_.on_event_(std::move(event));
 }
+void io_service::post_pending_events()
+{
+  batching_events_ = false;
+  if (pending_events_.empty())
+    return;
+  if (!event_ring_)
+    events_.emplace_bulk(pending_events_.begin(), pending_events_.end());
+  else
+    event_ring_->emplace_bulk(pending_events_.begin(), pending_events_.end());
+  pending_events_.clear();
+}
 void io_service::do_nonblocking_connect(io_channel* ctx)
 {
   assert(YDQS_CHECK_STATE(ctx->dns_queries_state_, YDQS_READY));
@@ -1106,6 +1491,7 @@ void io_service::do_nonblocking_connect(io_channel* ctx)
     this->ipsv_ = static_cast<u_short>(xxsocket::getipsv());
   if (ctx->socket_->is_open())
     cleanup_io(ctx);
+  close_connect_attempts(ctx);
 
   ctx->opmask_ &= ~YOPM_OPEN_CHANNEL;
 
@@ -1116,63 +1502,188 @@ void io_service::do_nonblocking_connect(io_channel* ctx)
   }
 
   ctx->state_ = io_base::state::OPENING;
-  auto& ep    = ctx->remote_eps_[0];
   YASIO_SLOG("[index: %d] connecting server %s:%u...", ctx->index_, ctx->remote_host_.c_str(),
              ctx->remote_port_);
 
+  if (ctx->properties_ & YCM_TCP)
+  { // happy eyeballs, connect the endpoints of interleaved families staggered, see RFC 8305
+    interleave_endpoints(ctx->remote_eps_);
+    ctx->next_ep_ = 0;
+    int error     = 0;
+    if (start_connect_attempt(ctx, error))
+    {
+      ctx->set_last_errno(EINPROGRESS);
+      ctx->timer_.expires_from_now(std::chrono::microseconds(options_.connect_timeout_));
+      ctx->timer_.async_wait_once([this, ctx]() {
+        if (ctx->state_ != io_base::state::OPEN)
+          handle_connect_failed(ctx, ETIMEDOUT);
+      });
+    }
+    else
+      this->handle_connect_failed(ctx, error);
+    return;
+  }
+
+  // udp, do not need to connect, we should set non-blocking mode manually
+  auto& ep = ctx->remote_eps_[0];
   if (ctx->socket_->open(ep.af(), ctx->protocol_))
   {
-    int ret = 0;
     if (ctx->properties_ & YCF_REUSEADDR)
       ctx->socket_->reuse_address(true);
     if (ctx->properties_ & YCF_EXCLUSIVEADDRUSE)
       ctx->socket_->reuse_address(false);
 
-    if ((ctx->local_port_ != 0 || !ctx->local_host_.empty() || ctx->properties_ & YCM_UDP))
-    {
-      auto ifaddr = ctx->local_host_.empty() ? YASIO_ADDR_ANY(ep.af()) : ctx->local_host_.c_str();
-      ctx->socket_->bind(ifaddr, ctx->local_port_);
-    }
-
-    // tcp connect directly, for udp do not need to connect.
-    if (ctx->properties_ & YCM_TCP)
-      ret = xxsocket::connect_n(ctx->socket_->native_handle(), ep);
-    else // udp, we should set non-blocking mode manually
-      ctx->socket_->set_nonblocking(true);
+    auto ifaddr = ctx->local_host_.empty() ? YASIO_ADDR_ANY(ep.af()) : ctx->local_host_.c_str();
+    ctx->socket_->bind(ifaddr, ctx->local_port_);
+    ctx->socket_->set_nonblocking(true);
 
     // join the multicast group for udp
     if (ctx->properties_ & YCPF_MCAST)
       ctx->join_multicast_group();
 
-    if (ret < 0)
-    { // setup no blocking connect
-      int error = xxsocket::get_last_errno();
-      if (error != EINPROGRESS && error != EWOULDBLOCK)
-      {
-        this->handle_connect_failed(ctx, error);
-      }
-      else
-      {
-        ctx->set_last_errno(EINPROGRESS);
-        register_descriptor(ctx->socket_->native_handle(), YEM_POLLIN | YEM_POLLOUT);
-        ctx->timer_.expires_from_now(std::chrono::microseconds(options_.connect_timeout_));
-        ctx->timer_.async_wait_once([this, ctx]() {
-          if (ctx->state_ != io_base::state::OPEN)
-            handle_connect_failed(ctx, ETIMEDOUT);
-        });
-      }
-    }
-    else if (ret == 0)
-    { // connect server successful immediately.
-      register_descriptor(ctx->socket_->native_handle(), YEM_POLLIN);
-      handle_connect_succeed(ctx, ctx->socket_);
-    } // !!!NEVER GO HERE
+    register_descriptor(ctx->socket_->native_handle(), YEM_POLLIN);
+    handle_connect_succeed(ctx, ctx->socket_);
   }
   else
     this->handle_connect_failed(ctx, xxsocket::get_last_errno());
 }
+void io_service::interleave_endpoints(std::vector<ip::endpoint>& eps)
+{
+  if (eps.size() < 3)
+    return;
+  auto af  = eps[0].af(); // the preferred family, the first one of resolved
+  auto mid = std::stable_partition(eps.begin(), eps.end(),
+                                   [af](const ip::endpoint& ep) { return ep.af() == af; });
+  if (mid == eps.end())
+    return;
+  std::vector<ip::endpoint> interleaved;
+  interleaved.reserve(eps.size());
+  for (auto first = eps.begin(), second = mid; first != mid || second != eps.end();)
+  {
+    if (first != mid)
+      interleaved.push_back(*first++);
+    if (second != eps.end())
+      interleaved.push_back(*second++);
+  }
+  eps.swap(interleaved);
+}
+bool io_service::start_connect_attempt(io_channel* ctx, int& error)
+{
+  while (ctx->next_ep_ < static_cast<int>(ctx->remote_eps_.size()))
+  {
+    auto& ep = ctx->remote_eps_[ctx->next_ep_++];
+    // the first attempt use the channel socket, the others will be swapped to it when won
+    auto s = !ctx->socket_->is_open() ? ctx->socket_ : std::make_shared<xxsocket>();
+    if (!s->open(ep.af(), ctx->protocol_))
+    {
+      error = xxsocket::get_last_errno();
+      continue;
+    }
+    if (ctx->properties_ & YCF_REUSEADDR)
+      s->reuse_address(true);
+    if (ctx->properties_ & YCF_EXCLUSIVEADDRUSE)
+      s->reuse_address(false);
+    if (ctx->local_port_ != 0 || !ctx->local_host_.empty())
+    {
+      auto ifaddr = ctx->local_host_.empty() ? YASIO_ADDR_ANY(ep.af()) : ctx->local_host_.c_str();
+      s->bind(ifaddr, ctx->local_port_);
+    }
+
+    // the connect complete immediately or not, check it at do_nonblocking_connect_completion
+    error = xxsocket::connect_n(s->native_handle(), ep) < 0 ? xxsocket::get_last_errno() : 0;
+    if (error != 0 && error != EINPROGRESS && error != EWOULDBLOCK)
+    {
+      YASIO_SLOG("[index: %d] connect %s failed, ec=%d, detail:%s", ctx->index_,
+                 ep.to_string().c_str(), error, io_service::strerror(error));
+      s->close();
+      continue;
+    }
+    register_descriptor(s->native_handle(), YEM_POLLIN | YEM_POLLOUT);
+    if (s != ctx->socket_)
+      ctx->attempts_.push_back(std::move(s));
+
+    // start next attempt if no attempt complete after delay
+    if (ctx->next_ep_ < static_cast<int>(ctx->remote_eps_.size()) &&
+        options_.connect_attempt_delay_ > 0)
+    {
+      ctx->attempt_timer_.expires_from_now(
+          std::chrono::microseconds(options_.connect_attempt_delay_));
+      ctx->attempt_timer_.async_wait_once([this, ctx]() {
+        int ec = 0;
+        if (ctx->state_ == io_base::state::OPENING && ctx->socket_->is_open())
+          start_connect_attempt(ctx, ec);
+      });
+    }
+    return true;
+  }
+  return false;
+}
+int io_service::check_connect_attempts(io_channel* ctx)
+{
+  if (ctx->opmask_ & YOPM_CLOSE_TRANSPORT)
+    return yasio::error::shutdown_by_localhost; // the channel closed by user when connecting
+
+  int error   = EINPROGRESS;
+  bool failed = false;
+  // index 0 is the channel socket, the others are the attempts started later
+  for (size_t i = 0; i <= ctx->attempts_.size();)
+  {
+    auto& s = i == 0 ? ctx->socket_ : ctx->attempts_[i - 1];
+    if (!s->is_open() || !poller_.is_ready(s->native_handle(), YEM_POLLIN | YEM_POLLOUT))
+    {
+      ++i;
+      continue;
+    }
+    int ec        = -1;
+    socklen_t len = sizeof(ec);
+    if (::getsockopt(s->native_handle(), SOL_SOCKET, SO_ERROR, (char*)&ec, &len) >= 0 && ec == 0)
+    { // won, the other attempts are no longer needed
+      if (i > 0)
+        ctx->socket_->swap(*s);
+      close_connect_attempts(ctx);
+      return 0;
+    }
+    unregister_descriptor(s->native_handle(), YEM_POLLIN | YEM_POLLOUT);
+    s->close();
+    error  = ec;
+    failed = true;
+    if (i == 0)
+    { // keep the channel socket in flight by the last attempt
+      if (ctx->attempts_.empty())
+        break;
+      ctx->socket_->swap(*ctx->attempts_.back());
+      ctx->attempts_.pop_back();
+    }
+    else
+      ctx->attempts_.erase(ctx->attempts_.begin() + (i - 1));
+  }
+
+  // start next attempt immediately when any attempt failed
+  if (failed)
+  {
+    int ec = error;
+    if (start_connect_attempt(ctx, ec))
+      return EINPROGRESS;
+    if (!ctx->socket_->is_open())
+      error = ec;
+  }
+  return ctx->socket_->is_open() ? EINPROGRESS : error;
+}
+void io_service::close_connect_attempts(io_channel* ctx)
+{
+  ctx->attempt_timer_.cancel();
+  for (auto& s : ctx->attempts_)
+  {
+    if (s->is_open())
+    {
+      unregister_descriptor(s->native_handle(), YEM_POLLIN | YEM_POLLOUT);
+      s->close();
+    }
+  }
+  ctx->attempts_.clear();
+}
 
-void io_service::do_nonblocking_connect_completion(io_channel* ctx, fd_set* fds_array)
+void io_service::do_nonblocking_connect_completion(io_channel* ctx)
 {
   assert((ctx->properties_ & YCM_TCP) && (ctx->properties_ & YCM_CLIENT));
   assert(ctx->state_ == io_base::state::OPENING);
@@ -1180,14 +1691,10 @@ void io_service::do_nonblocking_connect_completion(io_channel* ctx, fd_set* fds_
   if (ctx->state_ == io_base::state::OPENING)
   {
 #if !defined(YASIO_HAVE_SSL)
-    int error = -1;
-    if (FD_ISSET(ctx->socket_->native_handle(), &fds_array[write_op]) ||
-        FD_ISSET(ctx->socket_->native_handle(), &fds_array[read_op]))
+    int error = check_connect_attempts(ctx);
+    if (error != EINPROGRESS)
     {
-      socklen_t len = sizeof(error);
-      if (::getsockopt(ctx->socket_->native_handle(), SOL_SOCKET, SO_ERROR, (char*)&error, &len) >=
-              0 &&
-          error == 0)
+      if (error == 0)
       {
         // The nonblocking tcp handshake complete, remove write event avoid high-CPU occupation
         unregister_descriptor(ctx->socket_->native_handle(), YEM_POLLOUT);
@@ -1201,25 +1708,18 @@ void io_service::do_nonblocking_connect_completion(io_channel* ctx, fd_set* fds_
 #else
     if ((ctx->properties_ & YCPF_SSL_HANDSHAKING) == 0)
     {
-      int error = -1;
-      if (FD_ISSET(ctx->socket_->native_handle(), &fds_array[write_op]) ||
-          FD_ISSET(ctx->socket_->native_handle(), &fds_array[read_op]))
+      int error = check_connect_attempts(ctx);
+      if (error == 0)
       {
-        socklen_t len = sizeof(error);
-        if (::getsockopt(ctx->socket_->native_handle(), SOL_SOCKET, SO_ERROR, (char*)&error,
-                         &len) >= 0 &&
-            error == 0)
-        {
-          // The nonblocking tcp handshake complete, remove write event avoid high-CPU occupation
-          unregister_descriptor(ctx->socket_->native_handle(), YEM_POLLOUT);
-          if ((ctx->properties_ & YCM_SSL) == 0)
-            handle_connect_succeed(ctx, ctx->socket_);
-          else
-            do_ssl_handshake(ctx);
-        }
+        // The nonblocking tcp handshake complete, remove write event avoid high-CPU occupation
+        unregister_descriptor(ctx->socket_->native_handle(), YEM_POLLOUT);
+        if ((ctx->properties_ & YCM_SSL) == 0)
+          handle_connect_succeed(ctx, ctx->socket_);
         else
-          handle_connect_failed(ctx, error);
+          do_ssl_handshake(ctx);
       }
+      else if (error != EINPROGRESS)
+        handle_connect_failed(ctx, error);
     }
     else
       do_ssl_handshake(ctx);
@@ -1327,7 +1827,15 @@ void io_service::ares_getaddrinfo_cb(void* arg, int status, int timeouts, ares_a
 
   current_service.interrupt();
 }
-void io_service::process_ares_requests(fd_set* fds_array)
+void io_service::ares_sock_state_cb(void* data, socket_native_type fd, int readable, int writable)
+{ // The ares sockets register to poller directly, so it works for both select and epoll.
+  auto service = (io_service*)data;
+  int events   = (readable ? YEM_POLLIN : 0) | (writable ? YEM_POLLOUT : 0);
+  service->unregister_descriptor(fd, ~events & (YEM_POLLIN | YEM_POLLOUT));
+  if (events)
+    service->register_descriptor(fd, events);
+}
+void io_service::process_ares_requests()
 {
   if (this->ares_outstanding_work_ > 0)
   {
@@ -1339,8 +1847,9 @@ void io_service::process_ares_requests(fd_set* fds_array)
       if (ARES_GETSOCK_READABLE(bitmask, i) || ARES_GETSOCK_WRITABLE(bitmask, i))
       {
         auto fd = socks[i];
-        ::ares_process_fd(this->ares_, FD_ISSET(fd, &(fds_array[read_op])) ? fd : ARES_SOCKET_BAD,
-                          FD_ISSET(fd, &(fds_array[write_op])) ? fd : ARES_SOCKET_BAD);
+        ::ares_process_fd(this->ares_,
+                          poller_.is_ready(fd, YEM_POLLIN) ? fd : ARES_SOCKET_BAD,
+                          poller_.is_ready(fd, YEM_POLLOUT) ? fd : ARES_SOCKET_BAD);
       }
       else
         break;
@@ -1349,10 +1858,13 @@ void io_service::process_ares_requests(fd_set* fds_array)
 }
 void io_service::init_ares_channel()
 {
-  ares_options options = {};
-  options.timeout      = static_cast<int>(this->options_.dns_queries_timeout_ / std::micro::den);
-  options.tries        = this->options_.dns_queries_tries_;
-  auto status          = ::ares_init_options(&ares_, &options, ARES_OPT_TIMEOUTMS | ARES_OPT_TRIES);
+  ares_options options       = {};
+  options.timeout            = static_cast<int>(this->options_.dns_queries_timeout_ / std::micro::den);
+  options.tries              = this->options_.dns_queries_tries_;
+  options.sock_state_cb      = io_service::ares_sock_state_cb;
+  options.sock_state_cb_data = this;
+  auto status                = ::ares_init_options(
+      &ares_, &options, ARES_OPT_TIMEOUTMS | ARES_OPT_TRIES | ARES_OPT_SOCK_STATE_CB);
   if (status == ARES_SUCCESS)
   {
     YASIO_LOG("[c-ares] init channel succeed");
@@ -1435,7 +1947,7 @@ void io_service::do_nonblocking_accept(io_channel* ctx)
       return;
     }
 
-    if ((ctx->properties_ & YCM_UDP) || ctx->socket_->listen(YASIO_SOMAXCONN) == 0)
+    if ((ctx->properties_ & YCM_UDP) || ctx->socket_->listen(options_.tcp_backlog_) == 0)
     {
       ctx->state_ = io_base::state::OPEN;
       ctx->socket_->set_nonblocking(true);
@@ -1445,7 +1957,15 @@ void io_service::do_nonblocking_accept(io_channel* ctx)
         if (ctx->properties_ & YCPF_MCAST)
           ctx->join_multicast_group();
 
-        ctx->buffer_.resize(YASIO_INET_BUFFER_SIZE);
+#if YASIO__HAS_MMSG
+        // the slab for recvmmsg, one datagram per slot
+        int batch = (std::min)(options_.dgram_recv_batch_, YASIO__MAX_DGRAM_RECV_BATCH);
+        ctx->dgram_slot_size_ = batch > 1 ? options_.dgram_recv_size_ : 0;
+        if (ctx->dgram_slot_size_ > 0)
+          ctx->buffer_.resize(static_cast<size_t>(ctx->dgram_slot_size_) * batch);
+        else
+#endif
+          ctx->buffer_.resize(YASIO_INET_BUFFER_SIZE);
       }
       register_descriptor(ctx->socket_->native_handle(), YEM_POLLIN);
       YASIO_SLOG("[index: %d] socket.fd=%d listening at %s...", ctx->index_,
@@ -1461,12 +1981,12 @@ void io_service::do_nonblocking_accept(io_channel* ctx)
     }
   }
 }
-void io_service::do_nonblocking_accept_completion(io_channel* ctx, fd_set* fds_array)
+void io_service::do_nonblocking_accept_completion(io_channel* ctx)
 {
   if (ctx->state_ == io_base::state::OPEN)
   {
     int error = -1;
-    if (FD_ISSET(ctx->socket_->native_handle(), &fds_array[read_op]))
+    if (poller_.is_ready(ctx->socket_->native_handle(), YEM_POLLIN))
     {
       socklen_t len = sizeof(error);
       if (::getsockopt(ctx->socket_->native_handle(), SOL_SOCKET, SO_ERROR, (char*)&error, &len) >=
@@ -1474,65 +1994,241 @@ void io_service::do_nonblocking_accept_completion(io_channel* ctx, fd_set* fds_a
           error == 0)
       {
         if (ctx->properties_ & YCM_TCP)
-        {
-          socket_native_type sockfd;
-          error = ctx->socket_->accept_n(sockfd);
-          if (error == 0)
-            handle_connect_succeed(ctx, std::make_shared<xxsocket>(sockfd));
-          else // The non blocking tcp accept failed can be ignored.
-            YASIO_SLOGV("[index: %d] socket.fd=%d, accept failed, ec=%u", ctx->index(),
-                        (int)ctx->socket_->native_handle(), error);
-        }
-        else // YCM_UDP
-        {
-          ip::endpoint peer;
-          int n = ctx->socket_->recvfrom(&ctx->buffer_.front(),
-                                         static_cast<int>(ctx->buffer_.size()), peer);
-          if (n > 0)
+        { // accept the pending connections until EWOULDBLOCK or accept budget exhausted
+          int count = 0;
+          for (; count < options_.accept_budget_; ++count)
           {
-            YASIO_SLOGV("recvfrom peer: %s succeed.", peer.to_string().c_str());
-
-            /* make a transport local --> peer udp session, just like tcp accept */
-#if !defined(_WIN32)
-            auto transport = do_dgram_accept(ctx, peer);
-#else
-            // for win32, we manage dgram clients by ourself, and perfrom write operation only in
-            // dgram_transports, the read operation still dispatch by channel.
-            auto it = this->dgram_clients_.find(peer);
-            auto transport =
-                it != this->dgram_clients_.end() ? it->second : do_dgram_accept(ctx, peer);
-#endif
-            if (transport)
+            socket_native_type sockfd;
+            error = ctx->socket_->accept_n(sockfd, true);
+            if (error == 0)
+              handle_connect_succeed(ctx, std::make_shared<xxsocket>(sockfd));
+            else
             {
-              this->handle_event(event_ptr(new io_event(
-                  transport->ctx_->index(), YEK_PACKET,
-                  std::vector<char>(&ctx->buffer_.front(), &ctx->buffer_.front() + n), transport)));
+              if (error == EWOULDBLOCK || error == EAGAIN)
+                break;
+              // The non blocking tcp accept failed can be ignored.
+              ++stats_.accept_failed;
+              YASIO_SLOGV("[index: %d] socket.fd=%d, accept failed, ec=%u", ctx->index(),
+                          (int)ctx->socket_->native_handle(), error);
+              if (error != ECONNABORTED && error != EPROTO)
+                break;
             }
           }
-          else if (n < 0)
+          if (count > 0)
           {
-            error = xxsocket::get_last_errno();
-            if (YASIO_SHOULD_CLOSE_0(error))
-            {
-              YASIO_SLOG("[index: %d] recvfrom failed, ec=%d", ctx->index_, error);
-              close(ctx->index_);
-            }
+            stats_.accepted += count;
+            ++stats_.accept_batches;
+            if (count == options_.accept_budget_)
+              ++stats_.accept_budget_exhausted;
           }
         }
+        else
+        { // YCM_UDP, drain the datagrams until EAGAIN or the read budget exhausted
+          int received     = 0;
+          batching_events_ = options_.deferred_event_;
+          for (int n; received < options_.read_frame_budget_ && (n = do_dgram_recv(ctx)) > 0;)
+            received += n;
+          post_pending_events();
+        }
       }
     }
   }
 }
-transport_handle_t io_service::do_dgram_accept(io_channel* ctx, const ip::endpoint& peer)
+int io_service::do_dgram_recv(io_channel* ctx)
 {
-  auto client_sock = std::make_shared<xxsocket>();
-  if (client_sock->open(peer.af(), SOCK_DGRAM, 0))
-  {
-    if (ctx->properties_ & YCF_REUSEADDR)
-      client_sock->reuse_address(true);
-    if (ctx->properties_ & YCF_EXCLUSIVEADDRUSE)
-      client_sock->reuse_address(false);
-    int error = client_sock->bind(YASIO_ADDR_ANY(peer.af()), 0);
+  int n = 0;
+#if YASIO__HAS_MMSG
+  int slot_size = ctx->dgram_slot_size_;
+  if (slot_size > 0)
+  { // pull the pending datagrams into the slab with one system call
+    int batch = static_cast<int>(ctx->buffer_.size() / slot_size);
+    mmsghdr msgs[YASIO__MAX_DGRAM_RECV_BATCH];
+    io_vec bufs[YASIO__MAX_DGRAM_RECV_BATCH];
+    ip::endpoint peers[YASIO__MAX_DGRAM_RECV_BATCH];
+    transport_handle_t transports[YASIO__MAX_DGRAM_RECV_BATCH];
+    for (int i = 0; i < batch; ++i)
+    {
+      ::memset(&msgs[i], 0, sizeof(msgs[i]));
+      set_io_vec(bufs[i], &ctx->buffer_[i * slot_size], slot_size);
+      msgs[i].msg_hdr.msg_name    = &peers[i];
+      msgs[i].msg_hdr.msg_namelen = sizeof(peers[i]);
+      msgs[i].msg_hdr.msg_iov     = &bufs[i];
+      msgs[i].msg_hdr.msg_iovlen  = 1;
+    }
+    n = ::recvmmsg(ctx->socket_->native_handle(), msgs, batch, 0, nullptr);
+    if (n > 0)
+    {
+      ++stats_.dgram_recv_calls;
+      stats_.dgrams_received += n;
+      for (int i = 0; i < n; ++i)
+      {
+        transports[i] = nullptr;
+        if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC)
+        { // larger than slot, see YOPT_S_DGRAM_RECV_BATCH, don't make session for it
+          ++stats_.dgrams_truncated;
+          YASIO_SLOGV("[index: %d] drop truncated datagram from %s", ctx->index_,
+                      peers[i].to_string().c_str());
+          continue;
+        }
+        // the datagrams from same new peer in one batch should share one transport
+        transport_handle_t transport = nullptr;
+        for (int k = 0; k < i && !transport; ++k)
+          if (ip::endpoint_equal()(peers[k], peers[i]))
+            transport = transports[k];
+        if (!transport)
+          transport = dgram_transport_of(ctx, peers[i]);
+        transports[i] = transport;
+        if (transport)
+          handle_dgram(transport, &ctx->buffer_[i * slot_size],
+                       static_cast<int>(msgs[i].msg_len));
+      }
+    }
+  }
+  else
+#endif
+  {
+    ip::endpoint peer;
+    n = ctx->socket_->recvfrom(&ctx->buffer_.front(), static_cast<int>(ctx->buffer_.size()), peer);
+    if (n > 0)
+    {
+      YASIO_SLOGV("recvfrom peer: %s succeed.", peer.to_string().c_str());
+      ++stats_.dgram_recv_calls;
+      ++stats_.dgrams_received;
+      auto transport = dgram_transport_of(ctx, peer);
+      if (transport)
+        handle_dgram(transport, &ctx->buffer_.front(), n);
+      n = 1;
+    }
+  }
+  if (n < 0)
+  {
+    int error = xxsocket::get_last_errno();
+    if (YASIO_SHOULD_CLOSE_0(error))
+    {
+      YASIO_SLOG("[index: %d] recvfrom failed, ec=%d", ctx->index_, error);
+      close(ctx->index_);
+    }
+  }
+  return n;
+}
+transport_handle_t io_service::dgram_transport_of(io_channel* ctx, const ip::endpoint& peer)
+{
+  if (ctx->properties_ & YCF_UDP_DEMUX)
+  {
+    auto it = ctx->dgram_sessions_.find(peer);
+    if (it != ctx->dgram_sessions_.end())
+      return it->second;
+  }
+#if defined(_WIN32)
+  // for win32, we manage dgram clients by ourself, and perfrom write operation only in
+  // dgram_transports, the read operation still dispatch by channel.
+  auto it = this->dgram_clients_.find(peer);
+  if (it != this->dgram_clients_.end())
+    return it->second;
+#endif
+  /* make a transport local --> peer udp session, just like tcp accept */
+  return do_dgram_accept(ctx, peer);
+}
+void io_service::handle_dgram(transport_handle_t transport, const char* data, int size)
+{
+  if (transport->is_shared_socket())
+  { // feed the datagram to the demultiplexed session, just like received by itself
+    auto t         = static_cast<io_transport_udp*>(transport);
+    t->dgram_      = data;
+    t->dgram_size_ = size;
+    long long wait_duration = YASIO_MAX_WAIT_DURATION;
+    if (!do_read(transport, wait_duration))
+      transport->opmask_ |= YOPM_CLOSE_TRANSPORT; // close it at process_transports
+    else if (wait_duration >= YASIO_MAX_WAIT_DURATION)
+      return;
+    this->activate(transport);
+  }
+  else
+  {
+    auto packet = packet_pool::instance().acquire(size);
+    packet.assign(data, data + size);
+    this->handle_event(
+        event_ptr(new io_event(transport->ctx_->index(), YEK_PACKET, std::move(packet), transport)));
+  }
+}
+void io_service::wait_dgram_writable(transport_handle_t transport)
+{
+  auto ctx = transport->ctx_;
+  if (ctx->dgram_writers_.empty())
+  {
+    register_descriptor(ctx->socket_->native_handle(), YEM_POLLOUT);
+    this->dgram_writable_channels_.push_back(ctx);
+  }
+  transport->writer_slot_ = ctx->dgram_writers_.size();
+  ctx->dgram_writers_.push_back(transport);
+}
+void io_service::cancel_dgram_writable(transport_handle_t transport)
+{
+  transport->pollout_registered_ = false;
+  auto& writers                  = transport->ctx_->dgram_writers_;
+  auto slot                      = transport->writer_slot_;
+  if (slot < writers.size() && writers[slot] == transport)
+  { // swap and pop
+    writers[slot]               = writers.back();
+    writers[slot]->writer_slot_ = slot;
+    writers.pop_back();
+    if (writers.empty())
+      cancel_dgram_writable(transport->ctx_);
+  }
+}
+void io_service::cancel_dgram_writable(io_channel* ctx)
+{
+  auto it = std::find(dgram_writable_channels_.begin(), dgram_writable_channels_.end(), ctx);
+  if (it == dgram_writable_channels_.end())
+    return;
+  *it = dgram_writable_channels_.back();
+  dgram_writable_channels_.pop_back();
+  for (auto transport : ctx->dgram_writers_)
+    transport->pollout_registered_ = false;
+  ctx->dgram_writers_.clear();
+  if (ctx->socket_->is_open())
+    unregister_descriptor(ctx->socket_->native_handle(), YEM_POLLOUT);
+}
+void io_service::process_dgram_writable()
+{
+  for (size_t i = 0; i < dgram_writable_channels_.size();)
+  {
+    auto ctx = dgram_writable_channels_[i];
+    if (!poller_.is_ready(ctx->socket_->native_handle(), YEM_POLLOUT))
+    {
+      ++i;
+      continue;
+    }
+    unregister_descriptor(ctx->socket_->native_handle(), YEM_POLLOUT);
+    for (auto transport : ctx->dgram_writers_)
+    {
+      transport->pollout_registered_ = false;
+      activate_internal(transport);
+    }
+    ctx->dgram_writers_.clear();
+    dgram_writable_channels_[i] = dgram_writable_channels_.back();
+    dgram_writable_channels_.pop_back();
+  }
+}
+transport_handle_t io_service::do_dgram_accept(io_channel* ctx, const ip::endpoint& peer)
+{
+  if (ctx->properties_ & YCF_UDP_DEMUX)
+  { // share the server socket, the peers are demultiplexed by dgram_sessions_
+    auto transport = static_cast<io_transport_udp*>(allocate_transport(ctx, ctx->socket_));
+    transport->confgure_remote(peer, false);
+    ctx->dgram_sessions_.emplace(peer, transport);
+    handle_connect_succeed(transport);
+    return transport;
+  }
+
+  auto client_sock = std::make_shared<xxsocket>();
+  if (client_sock->open(peer.af(), SOCK_DGRAM, 0))
+  {
+    if (ctx->properties_ & YCF_REUSEADDR)
+      client_sock->reuse_address(true);
+    if (ctx->properties_ & YCF_EXCLUSIVEADDRUSE)
+      client_sock->reuse_address(false);
+    int error = client_sock->bind(YASIO_ADDR_ANY(peer.af()), 0);
     if (error == 0)
     {
       auto transport =
@@ -1560,15 +2256,20 @@ transport_handle_t io_service::do_dgram_accept(io_channel* ctx, const ip::endpoi
 }
 void io_service::handle_connect_succeed(transport_handle_t transport)
 {
+  transport->slot_ = this->transports_.size();
   this->transports_.push_back(transport);
   auto ctx = transport->ctx_;
   ctx->set_last_errno(0); // clear errno, value may be EINPROGRESS
   auto& connection = transport->socket_;
+  bool shared      = transport->is_shared_socket(); // the server channel receive for it
+  if (!shared)
+    this->transport_map_[connection->native_handle()] = transport;
   if (ctx->properties_ & YCM_CLIENT)
     ctx->state_ = io_base::state::OPEN;
-  else
-  { // tcp/udp server, accept a new client session
-    connection->set_nonblocking(true);
+  else if (!shared)
+  { // tcp/udp server, accept a new client session, the tcp session is non-blocking already
+    if (ctx->properties_ & YCM_UDP)
+      connection->set_nonblocking(true);
     register_descriptor(connection->native_handle(), YEM_POLLIN);
   }
   if (ctx->properties_ & YCM_TCP)
@@ -1595,7 +2296,7 @@ void io_service::notify_connect_succeed(transport_handle_t transport)
 
   YASIO_SLOG("[index: %d] the connection #%u [%s] --> [%s] is established.", ctx->index_,
              transport->id_, s->local_endpoint().to_string().c_str(),
-             s->peer_endpoint().to_string().c_str());
+             transport->peer_endpoint().to_string().c_str());
   this->handle_event(event_ptr(new io_event(ctx->index_, YEK_CONNECT_RESPONSE, 0, transport)));
 }
 transport_handle_t io_service::allocate_transport(io_channel* ctx, std::shared_ptr<xxsocket> socket)
@@ -1631,6 +2332,13 @@ void io_service::deallocate_transport(transport_handle_t t)
 {
   if (t && t->is_valid())
   {
+    if (t->activated_.exchange(false))
+    {
+      std::lock_guard<std::recursive_mutex> lck(this->activated_mtx_);
+      auto slot = t->activated_slot_;
+      if (slot < activated_transports_.size() && activated_transports_[slot] == t)
+        activated_transports_[slot] = nullptr;
+    }
     t->invalid();
     yasio::invoke_dtor(t);
     this->tpool_.push_back(t);
@@ -1643,14 +2351,14 @@ void io_service::handle_connect_failed(io_channel* ctx, int error)
   ctx->properties_ &= ~YCPF_SSL_HANDSHAKING;
 #endif
 
+  close_connect_attempts(ctx);
   cleanup_io(ctx);
 
   YASIO_SLOG("[index: %d] connect server %s:%u failed, ec=%d, detail:%s", ctx->index_,
              ctx->remote_host_.c_str(), ctx->remote_port_, error, io_service::strerror(error));
   this->handle_event(event_ptr(new io_event(ctx->index_, YEK_CONNECT_RESPONSE, error, nullptr)));
 }
-bool io_service::do_read(transport_handle_t transport, fd_set* fds_array,
-                         long long& max_wait_duration)
+bool io_service::do_read(transport_handle_t transport, long long& max_wait_duration)
 {
   bool ret = false;
   do
@@ -1664,88 +2372,155 @@ bool io_service::do_read(transport_handle_t transport, fd_set* fds_array,
       break;
     }
 
-    int n = 0, error = 0;
-    if (FD_ISSET(transport->socket_->native_handle(), &(fds_array[read_op])))
-      n = transport->do_read(error);
+    // the data left by budget exhausted is readable without the readiness of poll
+    if (!transport->read_pending_ &&
+        !poller_.is_ready(transport->socket_->native_handle(), YEM_POLLIN))
+    {
+      ret = true;
+      break;
+    }
 
-    if (n >= 0)
+    /* drain the socket until EAGAIN, the budget ensure fairness between transports, the
+       demultiplexed udp session only have one datagram to read. */
+    int n = 0, error = 0, count = 0, bytes = 0, frames = 0;
+    transport->read_pending_ = false;
+    do
     {
-      YASIO_SLOGV("[index: %d] do_read status ok, ec=%d, detail:%s", transport->cindex(), error,
-                  io_service::strerror(error));
-#if defined(YASIO_VERBOSE_LOG)
-      if (n > 0)
-      {
-        YASIO_SLOG("[index: %d] do_read ok, received data len: %d, "
-                   "buffer data "
-                   "len: %d",
-                   transport->cindex(), n, n + transport->offset_);
-      }
-#endif
-      if (transport->expected_size_ == -1)
-      { // decode length
-        int length = transport->ctx_->decode_len_(transport->buffer_, transport->wpos_ + n);
-        if (length > 0)
-        {
-          int bytes_to_strip =
-              ::yasio::clamp(transport->ctx_->lfb_.initial_bytes_to_strip, 0, length - 1);
-          transport->expected_size_ = length;
-          transport->expected_packet_.reserve(
-              (std::min)(length - bytes_to_strip,
-                         YASIO_MAX_PDU_BUFFER_SIZE)); // #perfomance, avoid memory reallocte.
-          unpack(transport, transport->expected_size_, n, bytes_to_strip, max_wait_duration);
-        }
-        else if (length == 0) // header insufficient, wait readfd ready at next event step.
-          transport->wpos_ += n;
-        else
-        {
-          transport->set_last_errno(yasio::error::invalid_packet);
-          break;
-        }
-      }
-      else
-      { // process incompleted pdu
-        unpack(transport,
-               transport->expected_size_ - static_cast<int>(transport->expected_packet_.size()), n,
-               0, max_wait_duration);
+      n = transport->do_read(error);
+      if (n <= 0)
+        break;
+      YASIO_SLOGV("[index: %d] do_read ok, received data len: %d", transport->cindex(), n);
+      if ((count = unpack(transport, n)) < 0)
+        break;
+      bytes += n;
+      frames += count;
+      if (bytes >= options_.read_budget_ || frames >= options_.read_frame_budget_)
+      { // the remain data will be read at next loop iteration
+        ++stats_.read_budget_exhausted;
+        transport->read_pending_ = true;
+        max_wait_duration        = 0;
+        break;
       }
-    }
-    else
-    { // n == 0: The return value will be 0 when the peer has performed an orderly shutdown.
+    } while (!transport->is_shared_socket());
+
+    if (n < 0)
+    { // error or the peer has performed an orderly shutdown
       transport->set_last_errno(error);
       break;
     }
+    if (count < 0)
+    {
+      transport->set_last_errno(yasio::error::invalid_packet);
+      break;
+    }
 
     ret = true;
   } while (false);
 
   return ret;
 }
-void io_service::unpack(transport_handle_t transport, int bytes_expected, int bytes_transferred,
-                        int bytes_to_strip, long long& max_wait_duration)
-{
-  auto bytes_available = bytes_transferred + transport->wpos_;
-  transport->expected_packet_.insert(
-      transport->expected_packet_.end(), transport->buffer_ + bytes_to_strip,
-      transport->buffer_ + (std::min)(bytes_expected, bytes_available));
+int io_service::unpack(transport_handle_t transport, int bytes_transferred)
+{
+  auto ctx             = transport->ctx_;
+  auto block           = transport->block_;
+  auto buffer          = transport->recv_buffer();
+  auto bytes_available = transport->wpos_ + bytes_transferred;
+  int offset           = transport->rpos_; // the read cursor of buffer
+  int pending          = 0; // the length of incomplete pdu kept in block
+  int frames           = 0;
+  while (offset < bytes_available)
+  {
+    int bytes_to_strip = 0;
+    bool head          = transport->expected_size_ == -1;
+    if (head)
+    { // decode length
+      int length = ctx->decode_len_(buffer + offset, bytes_available - offset);
+      if (length > 0)
+      {
+        bytes_to_strip            = ::yasio::clamp(ctx->lfb_.initial_bytes_to_strip, 0, length - 1);
+        transport->expected_size_ = length;
+        if (!block || length > buffer_block::capacity)
+          transport->expected_packet_ = packet_pool::instance().acquire((std::min)(
+              length - bytes_to_strip,
+              YASIO_MAX_PDU_BUFFER_SIZE)); // #perfomance, avoid memory reallocte.
+      }
+      else if (length == 0) // header insufficient, wait readfd ready at next event step.
+        break;
+      else
+        return -1;
+    }
 
-  // set wpos to bytes of remain buffer
-  transport->wpos_ = bytes_available - bytes_expected;
-  if (transport->wpos_ >= 0)
-  { /* pdu received properly */
-    if (transport->wpos_ > 0)
-    { /* move remain data to head of buffer and hold wpos. */
-      ::memmove(transport->buffer_, transport->buffer_ + bytes_expected, transport->wpos_);
-      max_wait_duration = 0;
+    // the bytes of current pdu not consumed yet, the stripped bytes consumed with head of pdu
+    int bytes_expected = transport->expected_size_ -
+                         static_cast<int>(transport->expected_packet_.size());
+    if (bytes_to_strip == 0)
+      bytes_expected -= ::yasio::clamp(ctx->lfb_.initial_bytes_to_strip, 0,
+                                       transport->expected_size_ - 1);
+    int bytes_consumed = (std::min)(bytes_expected, bytes_available - offset);
+    if (block && head)
+    { // the pdu starts in block, deliver it as slice or keep it until complete
+      if (bytes_consumed == bytes_expected)
+      {
+        buffer_slice slice(block, buffer + offset + bytes_to_strip,
+                           bytes_consumed - bytes_to_strip);
+        transport->expected_size_ = -1;
+        offset += bytes_consumed;
+        ++frames;
+        this->handle_event(
+            event_ptr(new io_event(ctx->index(), YEK_PACKET, std::move(slice), transport)));
+        continue;
+      }
+      if (bytes_expected <= buffer_block::capacity)
+      { // pdu incomplete, decode the head again when more data received
+        transport->expected_size_ = -1;
+        pending                   = bytes_expected;
+        break;
+      }
     }
+    if (bytes_consumed > bytes_to_strip)
+      transport->expected_packet_.insert(transport->expected_packet_.end(),
+                                         buffer + offset + bytes_to_strip,
+                                         buffer + offset + bytes_consumed);
+    offset += bytes_consumed;
+    if (bytes_consumed < bytes_expected) // pdu incomplete, continue recv remain data.
+      break;
+
     // move properly pdu to ready queue, the other thread who care about will retrieve it.
     YASIO_SLOGV("[index: %d] received a properly packet from peer, "
                 "packet size:%d",
                 transport->cindex(), transport->expected_size_);
-    this->handle_event(event_ptr(
-        new io_event(transport->ctx_->index(), YEK_PACKET, transport->fetch_packet(), transport)));
+    ++frames;
+    this->handle_event(
+        event_ptr(new io_event(ctx->index(), YEK_PACKET, transport->fetch_packet(), transport)));
+  }
+
+  int remain = bytes_available - offset;
+  if (!block)
+  { /* move remain data to head of private buffer once and hold wpos. */
+    transport->hold_recv_data(buffer + offset, remain);
+    return frames;
+  }
+
+  /* the delivered slices refer to the block before offset, rewind to head of block only when it's
+     free or the space insufficient, otherwise continue recv after the remain data. */
+  transport->rpos_ = offset;
+  transport->wpos_ = bytes_available;
+  bool unique      = block->unique();
+  if (offset > 0 && ((unique && remain == 0) || bytes_available > buffer_block::capacity / 4 * 3 ||
+                     offset + pending > buffer_block::capacity))
+  {
+    if (unique)
+      ::memmove(buffer, buffer + offset, remain);
+    else
+    { // the slices still in use, switch to new block
+      transport->block_ = new buffer_block();
+      ::memcpy(transport->block_->data(), buffer + offset, remain);
+      block->release();
+    }
+    transport->rpos_ = 0;
+    transport->wpos_ = remain;
   }
-  else /* all buffer consumed, set wpos to ZERO, pdu incomplete, continue recv remain data. */
-    transport->wpos_ = 0;
+  return frames;
 }
 highp_timer_ptr io_service::schedule(const std::chrono::microseconds& duration, timer_cb_t cb)
 {
@@ -1768,6 +2543,23 @@ void io_service::schedule_timer(highp_timer* timer_ctl, timer_cb_t&& timer_cb)
     return;
 
   std::lock_guard<std::recursive_mutex> lck(this->timer_queue_mtx_);
+#if !defined(YASIO_DISABLE_TIMER_WHEEL)
+  auto expires = expires_tick(timer_ctl);
+  auto node    = timer_ctl->wheel_node_;
+  if (node == nullptr)
+    timer_ctl->wheel_node_ = this->timer_wheel_.insert(
+        current_wheel_tick(), expires, timer_impl_t(timer_ctl, std::move(timer_cb)));
+  else
+  { // always replace timer_cb, and apply the new expire time
+    node->value.second = std::move(timer_cb);
+    if (node->expires != expires)
+      this->timer_wheel_.reschedule(node, expires);
+  }
+
+  // If the timer earlier than the planed wakeup, wakeup
+  if (expires < this->timer_wakeup_tick_)
+    this->interrupt();
+#else
   auto timer_it = this->find_timer(timer_ctl);
   if (timer_it == timer_queue_.end())
   {
@@ -1780,11 +2572,18 @@ void io_service::schedule_timer(highp_timer* timer_ctl, timer_cb_t&& timer_cb)
   }
   else // always replace timer_cb
     timer_it->second = std::move(timer_cb);
+#endif
 }
 void io_service::remove_timer(highp_timer* timer)
 {
   std::lock_guard<std::recursive_mutex> lck(this->timer_queue_mtx_);
-
+#if !defined(YASIO_DISABLE_TIMER_WHEEL)
+  if (timer->wheel_node_ != nullptr)
+  {
+    this->timer_wheel_.erase(timer->wheel_node_);
+    timer->wheel_node_ = nullptr;
+  }
+#else
   auto iter = this->find_timer(timer);
   if (iter != timer_queue_.end())
   {
@@ -1795,6 +2594,7 @@ void io_service::remove_timer(highp_timer* timer)
       this->interrupt();
     }
   }
+#endif
 }
 void io_service::open_internal(io_channel* ctx)
 {
@@ -1834,6 +2634,22 @@ bool io_service::close_internal(io_channel* ctx)
 }
 void io_service::process_timers()
 {
+#if !defined(YASIO_DISABLE_TIMER_WHEEL)
+  if (this->timer_wheel_.empty())
+    return;
+
+  std::lock_guard<std::recursive_mutex> lck(this->timer_queue_mtx_);
+  this->timer_wheel_.expire(current_wheel_tick(), [this](timer_impl_t&& timer_impl) {
+    auto timer_ctl         = timer_impl.first;
+    timer_ctl->wheel_node_ = nullptr;
+    if (!timer_impl.second() && timer_ctl->wheel_node_ == nullptr)
+    { // reschedule if the timer want wait again
+      timer_ctl->expires_from_now();
+      timer_ctl->wheel_node_ = this->timer_wheel_.insert(
+          current_wheel_tick(), expires_tick(timer_ctl), std::move(timer_impl));
+    }
+  });
+#else
   if (this->timer_queue_.empty())
     return;
 
@@ -1861,40 +2677,47 @@ void io_service::process_timers()
   }
   if (n)
     sort_timers();
+#endif
 }
-int io_service::do_select(fd_set* fdsa, long long max_wait_duration)
+int io_service::do_poll(long long max_wait_duration)
 {
-  int retval = 1;
-
-  ::memcpy(fdsa, this->fds_array_, sizeof(this->fds_array_));
-
   auto wait_duration = get_wait_duration(max_wait_duration);
-  if (wait_duration > 0)
+  if (wait_duration < 0)
+    wait_duration = 0;
+
+#if defined(YASIO_HAVE_CARES)
+  if (this->ares_outstanding_work_ > 0)
   {
     timeval waitd_tv = {(decltype(timeval::tv_sec))(wait_duration / 1000000),
                         (decltype(timeval::tv_usec))(wait_duration % 1000000)};
-
-#if defined(YASIO_HAVE_CARES)
-    int nfds = -1;
-    if (this->ares_outstanding_work_ > 0 &&
-        (nfds = ::ares_fds(this->ares_, &fdsa[read_op], &fdsa[write_op])) > 0)
-    {
-      ::ares_timeout(this->ares_, &waitd_tv, &waitd_tv);
-      if (this->max_nfds_ < nfds)
-        this->max_nfds_ = nfds;
-    }
+    ::ares_timeout(this->ares_, &waitd_tv, &waitd_tv);
+    wait_duration = static_cast<long long>(waitd_tv.tv_sec) * 1000000 + waitd_tv.tv_usec;
+  }
 #endif
 
-    YASIO_SLOGV("socket.select maxfdp:%d waiting... %ld milliseconds", maxfdp_,
-                waitd_tv.tv_sec * 1000 + waitd_tv.tv_usec / 1000);
-    retval = ::select(this->max_nfds_, &(fdsa[read_op]), &(fdsa[write_op]), nullptr, &waitd_tv);
-    YASIO_SLOGV("socket.select waked up, retval=%d", retval);
-  }
+  YASIO_SLOGV("do_poll waiting... %lld milliseconds", wait_duration / 1000);
+  int retval = poller_.poll_io(wait_duration);
+  YASIO_SLOGV("do_poll waked up, retval=%d", retval);
 
   return retval;
 }
 long long io_service::get_wait_duration(long long usec)
 {
+#if !defined(YASIO_DISABLE_TIMER_WHEEL)
+  std::lock_guard<std::recursive_mutex> lck(this->timer_queue_mtx_);
+  if (this->timer_wheel_.empty())
+  {
+    this->timer_wakeup_tick_ = static_cast<timer_wheel_t::tick_type>(-1);
+    return usec;
+  }
+
+  this->timer_wakeup_tick_ = this->timer_wheel_.next_expiry();
+
+  // microseconds
+  auto duration =
+      static_cast<long long>(this->timer_wakeup_tick_) * YASIO_TIMER_WHEEL_TICK - highp_clock();
+  return (std::min)((std::max)(duration, 0LL), usec);
+#else
   if (this->timer_queue_.empty())
     return usec;
 
@@ -1907,6 +2730,7 @@ long long io_service::get_wait_duration(long long usec)
     return duration.count();
   else
     return usec;
+#endif
 }
 bool io_service::cleanup_io(io_base* obj, bool clear_state)
 {
@@ -1916,7 +2740,12 @@ bool io_service::cleanup_io(io_base* obj, bool clear_state)
     obj->state_ = io_base::state::CLOSED;
   if (obj->socket_->is_open())
   {
-    unregister_descriptor(obj->socket_->native_handle(), YEM_POLLIN | YEM_POLLOUT);
+    auto fd = obj->socket_->native_handle();
+    // the transport mapped by it's socket, which is shared by the client channel
+    auto it = this->transport_map_.find(fd);
+    if (it != this->transport_map_.end() && it->second->socket_ == obj->socket_)
+      this->transport_map_.erase(it);
+    unregister_descriptor(fd, YEM_POLLIN | YEM_POLLOUT);
     obj->socket_->close();
     return true;
   }
@@ -1928,13 +2757,26 @@ u_short io_service::query_ares_state(io_channel* ctx)
       !YDQS_CHECK_STATE(ctx->dns_queries_state_, YDQS_INPRROGRESS))
   {
     auto diff = (highp_clock() - ctx->dns_queries_timestamp_);
-    if (YDQS_CHECK_STATE(ctx->dns_queries_state_, YDQS_READY) &&
-        diff >= options_.dns_cache_timeout_)
+#if !defined(YASIO_HAVE_CARES)
+    // The expired record still used until max staleness reached, see refresh_resolve
+    auto expires = options_.dns_cache_timeout_ + options_.dns_max_staleness_;
+#else
+    auto expires = options_.dns_cache_timeout_;
+#endif
+    if (YDQS_CHECK_STATE(ctx->dns_queries_state_, YDQS_READY) && diff >= expires)
       YDQS_SET_STATE(ctx->dns_queries_state_, YDQS_DIRTY);
 
     if (YDQS_CHECK_STATE(ctx->dns_queries_state_, YDQS_DIRTY))
       start_resolve(ctx);
+#if !defined(YASIO_HAVE_CARES)
+    else if (YDQS_CHECK_STATE(ctx->dns_queries_state_, YDQS_READY) && diff >= dns_prefetch_age())
+      refresh_resolve(ctx);
+#endif
   }
+#if !defined(YASIO_HAVE_CARES)
+  else if (YDQS_CHECK_STATE(ctx->dns_queries_state_, YDQS_INPRROGRESS))
+    finish_resolve(ctx);
+#endif
 
   return YDQS_GET_STATE(ctx->dns_queries_state_);
 }
@@ -1952,24 +2794,210 @@ void io_service::start_resolve(io_channel* ctx)
   ctx->ares_start_time_ = highp_clock();
 #endif
 #if !defined(YASIO_HAVE_CARES)
-  std::thread async_resolv_thread([=] {
-    int error = options_.resolv_(ctx->remote_eps_, ctx->remote_host_.c_str(), ctx->remote_port_);
+  /* the channels resolve same host share one dns record, the record which in flight will not be
+     queried again, the fresh one apply to channel immediately. */
+  ctx->dns_key_ = ctx->remote_host_;
+  ctx->dns_key_.push_back(':');
+  ctx->dns_key_ += std::to_string(ctx->remote_port_);
+  ctx->dns_key_.push_back('/');
+  ctx->dns_key_ += std::to_string(this->ipsv_);
+  {
+    std::lock_guard<std::mutex> lck(this->dns_->mtx);
+    auto& record = this->dns_->cache[ctx->dns_key_];
+    auto age     = highp_clock() - record.timestamp;
+    if (record.timestamp != 0 &&
+        age < options_.dns_cache_timeout_ + options_.dns_max_staleness_)
+    { // the stale record served while refreshing
+      if (age < options_.dns_cache_timeout_)
+        ++stats_.dns_cache_hits;
+      else
+        ++stats_.dns_stale_hits;
+      if (!record.pending && age >= dns_prefetch_age())
+      {
+        ++stats_.dns_prefetches;
+        enqueue_resolve(ctx->dns_key_);
+      }
+    }
+    else if (record.pending)
+      ++stats_.dns_queries_coalesced;
+    else
+    {
+      ++stats_.dns_cache_misses;
+      record.host = ctx->remote_host_;
+      record.port = ctx->remote_port_;
+      enqueue_resolve(ctx->dns_key_);
+    }
+  }
+  finish_resolve(ctx);
+#else
+  ares_addrinfo_hints hint;
+  memset(&hint, 0x0, sizeof(hint));
+  hint.ai_family = local_address_family();
+  char sport[sizeof "65535"] = {'\0'};
+  const char* service = nullptr;
+  if (ctx->remote_port_ > 0)
+  {
+    sprintf(sport, "%u", ctx->remote_port_); // It's enough for unsigned short, so use sprintf ok.
+    service = sport;
+  }
+
+  ares_work_started();
+  ::ares_getaddrinfo(this->ares_, ctx->remote_host_.c_str(), service, &hint,
+                     io_service::ares_getaddrinfo_cb, ctx);
+#endif
+}
+#if !defined(YASIO_HAVE_CARES)
+void io_service::finish_resolve(io_channel* ctx)
+{
+  int error = 0;
+  {
+    std::lock_guard<std::mutex> lck(this->dns_->mtx);
+    auto it = this->dns_->cache.find(ctx->dns_key_);
+    if (it == this->dns_->cache.end())
+      return;
+    auto& record = it->second;
+    if (record.pending &&
+        (record.timestamp == 0 || highp_clock() - record.timestamp >=
+                                      options_.dns_cache_timeout_ + options_.dns_max_staleness_))
+      return; // wait the query in flight
+    error = record.error;
     if (error == 0)
     {
-      ctx->dns_queries_state_     = YDQS_READY;
-      ctx->dns_queries_timestamp_ = highp_clock();
+      ctx->remote_eps_            = record.endpoints;
+      ctx->dns_queries_timestamp_ = record.timestamp;
+    }
+  }
+  if (error == 0)
+  {
+    YDQS_SET_STATE(ctx->dns_queries_state_, YDQS_READY);
+    schedule_dns_refresh();
 #  if defined(YASIO_ENABLE_ARES_PROFILER)
-      YASIO_SLOG("[index: %d] resolve %s succeed, cost: %g(ms)", ctx->index_,
-                 ctx->remote_host_.c_str(),
-                 (ctx->dns_queries_timestamp_ - ctx->ares_start_time_) / 1000.0);
+    YASIO_SLOG("[index: %d] resolve %s succeed, cost: %g(ms)", ctx->index_,
+               ctx->remote_host_.c_str(), (highp_clock() - ctx->ares_start_time_) / 1000.0);
 #  endif
+  }
+  else
+  {
+    YASIO_SLOG("[index: %d] resolve %s failed, ec=%d, detail:%s", ctx->index_,
+               ctx->remote_host_.c_str(), error, xxsocket::gai_strerror(error));
+    YDQS_SET_STATE(ctx->dns_queries_state_, YDQS_FAILED);
+  }
+}
+void io_service::refresh_resolve(io_channel* ctx)
+{
+  std::lock_guard<std::mutex> lck(this->dns_->mtx);
+  auto it = this->dns_->cache.find(ctx->dns_key_);
+  if (it == this->dns_->cache.end())
+    return;
+  auto& record = it->second;
+  if (record.timestamp > ctx->dns_queries_timestamp_)
+  { // refreshed at background, apply to channel
+    ctx->remote_eps_            = record.endpoints;
+    ctx->dns_queries_timestamp_ = record.timestamp;
+  }
+  auto age = highp_clock() - ctx->dns_queries_timestamp_;
+  if (age >= options_.dns_cache_timeout_)
+    ++stats_.dns_stale_hits;
+  if (!record.pending && age >= dns_prefetch_age())
+  {
+    ++stats_.dns_prefetches;
+    enqueue_resolve(ctx->dns_key_);
+  }
+}
+void io_service::schedule_dns_refresh()
+{
+  if (dns_refresh_scheduled_)
+    return;
+  dns_refresh_scheduled_ = true;
+  // check at half of the prefetch window, so the record refreshed before it's expired
+  auto interval = (options_.dns_cache_timeout_ - dns_prefetch_age()) / 2;
+  dns_refresh_timer_.expires_from_now(
+      std::chrono::microseconds((std::max)(interval, 100LL * std::milli::den)));
+  dns_refresh_timer_.async_wait([this]() {
+    if (refresh_dns_records())
+      return false; // wait again
+    dns_refresh_scheduled_ = false;
+    return true;
+  });
+}
+bool io_service::refresh_dns_records()
+{
+  bool referenced = false;
+  auto now        = highp_clock();
+  std::lock_guard<std::mutex> lck(this->dns_->mtx);
+  for (auto ctx : this->channels_)
+  {
+    if (ctx->dns_key_.empty() || ctx->state_ == io_base::state::CLOSED)
+      continue;
+    referenced = true;
+    auto it    = this->dns_->cache.find(ctx->dns_key_);
+    if (it == this->dns_->cache.end())
+      continue;
+    auto& record = it->second;
+    if (!record.pending && record.timestamp != 0 && now - record.timestamp >= dns_prefetch_age())
+    {
+      ++stats_.dns_prefetches;
+      enqueue_resolve(ctx->dns_key_);
     }
-    else
+  }
+  return referenced;
+}
+void io_service::enqueue_resolve(const std::string& key)
+{
+  auto& record   = this->dns_->cache[key];
+  record.pending = true;
+  record.ipsv    = this->ipsv_;
+  record.resolv  = options_.resolv_;
+  record.max_age = options_.dns_cache_timeout_ + options_.dns_max_staleness_;
+  this->dns_->queue.push_back(key);
+  if (!this->dns_->started)
+  {
+    this->dns_->started = true;
+    for (int i = 0; i < YASIO_DNS_RESOLVER_THREADS; ++i)
+      std::thread(&io_service::resolver_loop, this, this->dns_).detach();
+  }
+  this->dns_->cv.notify_one();
+}
+void io_service::resolver_loop(std::shared_ptr<dns_state> dns)
+{
+  std::unique_lock<std::mutex> lck(dns->mtx);
+  for (;;)
+  {
+    dns->cv.wait(lck, [&dns] { return dns->stopping || !dns->queue.empty(); });
+    if (dns->stopping)
+      break;
+
+    auto key = std::move(dns->queue.front());
+    dns->queue.pop_front();
+    auto& query = dns->cache[key];
+    auto host   = query.host;
+    auto port   = query.port;
+    auto ipsv   = query.ipsv;
+    auto resolv = query.resolv;
+    lck.unlock();
+
+    std::vector<ip::endpoint> endpoints;
+    int error = resolv ? resolv(endpoints, host.c_str(), port)
+                       : yasio__builtin_resolv(endpoints, host.c_str(), port, ipsv);
+
+    lck.lock();
+    if (dns->stopping)
+      break; // the service stopped when querying, it may be destroyed
+
+    auto& record = dns->cache[key];
+    if (error == 0)
     {
-      YASIO_SLOG("[index: %d] resolve %s failed, ec=%d, detail:%s", ctx->index_,
-                 ctx->remote_host_.c_str(), error, xxsocket::gai_strerror(error));
-      YDQS_SET_STATE(ctx->dns_queries_state_, YDQS_FAILED);
+      record.endpoints.swap(endpoints);
+      record.error     = 0;
+      record.timestamp = highp_clock();
     }
+    else if (record.timestamp == 0 || highp_clock() - record.timestamp >= record.max_age)
+    {
+      record.endpoints.clear();
+      record.error     = error;
+      record.timestamp = 0;
+    } // else: the refresh failed, keep the stale record until max staleness reached
+    record.pending = false;
     /*
     The getaddrinfo behavior at win32 is strange:
     If the channel 0 is in non-blocking connect, and waiting at select, than
@@ -1982,38 +3010,64 @@ void io_service::start_resolve(io_channel* ctx)
     Another result at this situation is: Try get local endpoint by getsockname
     will return 0.0.0.0
     */
-    this->interrupt();
-  });
-  async_resolv_thread.detach();
-#else
-  ares_addrinfo_hints hint;
-  memset(&hint, 0x0, sizeof(hint));
-  hint.ai_family = local_address_family();
-  char sport[sizeof "65535"] = {'\0'};
-  const char* service = nullptr;
-  if (ctx->remote_port_ > 0)
+    this->interrupt(); // safe with dns->mtx locked, the service can't stop meanwhile
+  }
+}
+void io_service::stop_resolvers()
+{
   {
-    sprintf(sport, "%u", ctx->remote_port_); // It's enough for unsigned short, so use sprintf ok.
-    service = sport;
+    std::lock_guard<std::mutex> lck(this->dns_->mtx);
+    this->dns_->stopping = true;
+    this->dns_->queue.clear();
   }
-
-  ares_work_started();
-  ::ares_getaddrinfo(this->ares_, ctx->remote_host_.c_str(), service, &hint,
-                     io_service::ares_getaddrinfo_cb, ctx);
-#endif
+  this->dns_->cv.notify_all();
+  // the detached threads release the state after the queries in flight complete
+  this->dns_.reset();
 }
+#endif
 int io_service::builtin_resolv(std::vector<ip::endpoint>& endpoints, const char* hostname,
                                unsigned short port)
 {
-  if (this->ipsv_ & ipsv_ipv4)
-    return xxsocket::resolve_v4(endpoints, hostname, port);
-  else if (this->ipsv_ & ipsv_ipv6) // localhost is IPv6_only network
-    return xxsocket::resolve_v6(endpoints, hostname, port) != 0
-               ? xxsocket::resolve_v4to6(endpoints, hostname, port)
-               : 0;
-  return -1;
+  return yasio__builtin_resolv(endpoints, hostname, port, this->ipsv_);
+}
+void io_service::interrupt()
+{
+  // only the first interrupt since the loop last reset the interrupter need signal
+  if (!wakeup_pending_.exchange(true))
+  {
+    interrupter_.interrupt();
+    ++stats_.wakeups;
+  }
+  else
+    ++stats_.wakeups_suppressed;
+}
+void io_service::activate(transport_handle_t transport)
+{
+#if defined(_WIN32)
+  // The udp server sessions at win32 are performed by dgram_clients_ every loop.
+  if ((transport->ctx_->properties_ & (YCM_UDP | YCM_SERVER)) == (YCM_UDP | YCM_SERVER) &&
+      !transport->is_shared_socket())
+  {
+    this->interrupt();
+    return;
+  }
+#endif
+  if (!transport->activated_.exchange(true))
+  {
+    std::lock_guard<std::recursive_mutex> lck(this->activated_mtx_);
+    transport->activated_slot_ = this->activated_transports_.size();
+    this->activated_transports_.push_back(transport);
+  }
+  this->interrupt();
+}
+void io_service::activate_internal(transport_handle_t transport)
+{
+  if (!transport->active_)
+  {
+    transport->active_ = true;
+    this->active_transports_.push_back(transport);
+  }
 }
-void io_service::interrupt() { interrupter_.interrupt(); }
 const char* io_service::strerror(int error)
 {
   switch (error)
@@ -2058,9 +3112,16 @@ void io_service::set_option_internal(int opt, va_list ap) // lgtm [cpp/poorly-do
       options_.tcp_keepalive_.interval = va_arg(ap, int);
       options_.tcp_keepalive_.probs    = va_arg(ap, int);
       break;
-    case YOPT_S_RESOLV_FN:
-      options_.resolv_ = *va_arg(ap, resolv_fn_t*);
+    case YOPT_S_RESOLV_FN: {
+      auto fn = va_arg(ap, resolv_fn_t*);
+#if !defined(YASIO_HAVE_CARES)
+      std::unique_lock<std::mutex> lck; // the resolver snapshot at enqueue_resolve
+      if (dns_) // null when not initialized or cleaned up
+        lck = std::unique_lock<std::mutex>(dns_->mtx);
+#endif
+      options_.resolv_ = fn ? *fn : nullptr;
       break;
+    }
     case YOPT_S_PRINT_FN:
       this->options_.print_ = *va_arg(ap, print_fn_t*);
       break;
@@ -2075,9 +3136,18 @@ void io_service::set_option_internal(int opt, va_list ap) // lgtm [cpp/poorly-do
     case YOPT_S_CONNECT_TIMEOUT:
       options_.connect_timeout_ = static_cast<highp_time_t>(va_arg(ap, int)) * std::micro::den;
       break;
+    case YOPT_S_CONNECT_ATTEMPT_DELAY:
+      options_.connect_attempt_delay_ = static_cast<highp_time_t>(va_arg(ap, int)) * 1000;
+      break;
     case YOPT_S_DNS_CACHE_TIMEOUT:
       options_.dns_cache_timeout_ = static_cast<highp_time_t>(va_arg(ap, int)) * std::micro::den;
       break;
+    case YOPT_S_DNS_MAX_STALENESS:
+      options_.dns_max_staleness_ = static_cast<highp_time_t>(va_arg(ap, int)) * std::micro::den;
+      break;
+    case YOPT_S_DNS_PREFETCH_THRESHOLD:
+      options_.dns_prefetch_threshold_ = ::yasio::clamp(va_arg(ap, int), 1, 100);
+      break;
     case YOPT_S_DNS_QUERIES_TIMEOUT:
       options_.dns_queries_timeout_ = static_cast<highp_time_t>(va_arg(ap, int)) * std::micro::den;
       break;
@@ -2087,6 +3157,34 @@ void io_service::set_option_internal(int opt, va_list ap) // lgtm [cpp/poorly-do
     case YOPT_S_DNS_QUERIES_TRIES:
       options_.dns_queries_tries_ = va_arg(ap, int);
       break;
+    case YOPT_S_TCP_BACKLOG:
+      options_.tcp_backlog_ = (std::max)(va_arg(ap, int), 1);
+      break;
+    case YOPT_S_ACCEPT_BUDGET:
+      options_.accept_budget_ = (std::max)(va_arg(ap, int), 1);
+      break;
+    case YOPT_S_READ_BUDGET:
+      options_.read_budget_       = (std::max)(va_arg(ap, int), 1);
+      options_.read_frame_budget_ = (std::max)(va_arg(ap, int), 1);
+      break;
+    case YOPT_S_WRITE_BUDGET:
+      options_.write_budget_ = (std::max)(va_arg(ap, int), 1);
+      break;
+    case YOPT_S_DGRAM_RECV_BATCH:
+      options_.dgram_recv_batch_ = (std::max)(va_arg(ap, int), 1);
+      options_.dgram_recv_size_  = (std::min)((std::max)(va_arg(ap, int), 1), YASIO_INET_BUFFER_SIZE);
+      break;
+    case YOPT_S_EVENT_RING: {
+      int capacity = va_arg(ap, int);
+      if (this->state_ != io_service::state::RUNNING)
+      {
+        if (capacity > 0)
+          this->event_ring_.reset(new concurrency::ring_queue<event_ptr>(capacity));
+        else
+          this->event_ring_.reset();
+      }
+      break;
+    }
     case YOPT_C_LFBFD_PARAMS: {
       auto channel = channel_at(static_cast<size_t>(va_arg(ap, int)));
       if (channel)
@@ -2104,6 +3202,12 @@ void io_service::set_option_internal(int opt, va_list ap) // lgtm [cpp/poorly-do
         channel->lfb_.initial_bytes_to_strip = ::yasio::clamp(va_arg(ap, int), 0, YASIO_MAX_IBTS);
       break;
     }
+    case YOPT_C_RECV_BUFFER_SIZE: {
+      auto channel = channel_at(static_cast<size_t>(va_arg(ap, int)));
+      if (channel)
+        channel->rbuf_size_ = ::yasio::clamp(va_arg(ap, int), 64, YASIO_MAX_PDU_BUFFER_SIZE);
+      break;
+    }
     case YOPT_S_EVENT_CB:
       options_.on_event_ = *va_arg(ap, io_event_cb_t*);
       break;
@@ -2204,6 +3308,87 @@ void io_service::set_option_internal(int opt, va_list ap) // lgtm [cpp/poorly-do
     }
   }
 }
+
+// ------------------------ io_service_group ------------------------
+io_service_group::io_service_group(int concurrency, const io_hostent* channel_eps,
+                                   int channel_count)
+{
+  if (concurrency < 1)
+    concurrency = 1;
+  for (int i = 0; i < concurrency; ++i)
+    services_.push_back(cxx17::make_unique<io_service>(channel_eps, channel_count));
+}
+io_service_group::~io_service_group() { this->stop(); }
+void io_service_group::start(io_event_cb_t cb)
+{
+  for (auto& service : services_)
+  {
+    service->set_option(YOPT_S_NO_NEW_THREAD, 0);
+    service->start(cb);
+  }
+}
+void io_service_group::stop()
+{
+  for (auto& service : services_)
+    service->stop();
+}
+void io_service_group::dispatch(int count)
+{
+  for (auto& service : services_)
+    service->dispatch(count);
+}
+void io_service_group::dispatch_batch(int count, const io_event_batch_cb_t& cb)
+{
+  for (auto& service : services_)
+    service->dispatch_batch(count, cb);
+}
+void io_service_group::set_option(int opt, ...)
+{
+  va_list ap;
+  va_start(ap, opt);
+  if (opt != YOPT_T_BIND_UDP && opt != YOPT_SOCKOPT)
+  {
+    for (auto& service : services_)
+    {
+      va_list args;
+      va_copy(args, ap);
+      service->set_option_internal(opt, args);
+      va_end(args);
+    }
+  }
+  else // the transport or io_base option, apply to the object once
+    services_[0]->set_option_internal(opt, ap);
+  va_end(ap);
+}
+void io_service_group::open(size_t cindex, int kind)
+{
+  if (kind & YCM_SERVER)
+  {
+#if defined(__linux__)
+    for (auto& service : services_)
+    {
+      service->set_option(YOPT_C_MOD_FLAGS, static_cast<int>(cindex), YCF_REUSEADDR, 0);
+      service->open(cindex, kind);
+    }
+#else
+    services_[0]->open(cindex, kind);
+#endif
+  }
+  else
+    services_[cindex % services_.size()]->open(cindex, kind);
+}
+void io_service_group::close(int cindex)
+{
+  for (auto& service : services_)
+    service->close(cindex);
+}
+bool io_service_group::is_open(int cindex) const
+{
+  for (auto& service : services_)
+    if (service->is_open(cindex))
+      return true;
+  return false;
+}
 } // namespace inet
 } // namespace yasio
 
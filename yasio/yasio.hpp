@@ -32,9 +32,11 @@ SOFTWARE.
 #include <algorithm>
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 #include <chrono>
 #include <functional>
@@ -47,7 +49,11 @@ SOFTWARE.
 #include "yasio/detail/object_pool.hpp"
 #include "yasio/detail/singleton.hpp"
 #include "yasio/detail/select_interrupter.hpp"
+#include "yasio/detail/poller.hpp"
+#include "yasio/detail/timer_wheel.hpp"
 #include "yasio/detail/concurrent_queue.hpp"
+#include "yasio/detail/buffer_slice.hpp"
+#include "yasio/detail/packet_pool.hpp"
 #include "yasio/detail/utils.hpp"
 #include "yasio/cxx17/memory.hpp"
 #include "yasio/cxx17/string_view.hpp"
@@ -79,8 +85,9 @@ enum
   // params: deferred_event:int(1)
   YOPT_S_DEFERRED_EVENT = 1,
 
-  // Set custom resolve function, native C++ ONLY
-  // params: func:resolv_fn_t*
+  // Set custom resolve function, native C++ ONLY, it's called at the resolver threads and may
+  // called after io_service destroyed when a query in flight, ensure thread safe & lifetime of it.
+  // params: func:resolv_fn_t*, nullptr or empty to use builtin resolve
   YOPT_S_RESOLV_FN,
 
   // Set custom print function, native C++ ONLY, you must ensure thread safe of it.
@@ -134,6 +141,54 @@ enum
   //        b. relative option: YOPT_S_DNS_QUERIES_TIMEOUT
   YOPT_S_DNS_QUERIES_TRIES,
 
+  // Sets the listen backlog of tcp server
+  // params: backlog : int(YASIO_SOMAXCONN)
+  // remark: only affect the server channels opened after set
+  YOPT_S_TCP_BACKLOG,
+
+  // Sets the max connections accepted by tcp server at one loop iteration
+  // params: budget : int(YASIO_ACCEPT_BUDGET)
+  YOPT_S_ACCEPT_BUDGET,
+
+  // Sets the max bytes and frames received by one transport at one loop iteration
+  // params: bytes : int(YASIO_READ_BUDGET), frames : int(YASIO_READ_FRAME_BUDGET)
+  YOPT_S_READ_BUDGET,
+
+  // Sets the max bytes sent by one transport at one loop iteration
+  // params: bytes : int(YASIO_WRITE_BUDGET)
+  YOPT_S_WRITE_BUDGET,
+
+  // Sets the max datagrams received by udp server with one recvmmsg call, linux ONLY
+  // params: batch : int(YASIO_DGRAM_RECV_BATCH), 1 to use recvfrom
+  //         size : int(YASIO_DGRAM_RECV_SIZE), the max size of each datagram
+  // remark: only affect the server channels opened after set, the datagrams larger than size
+  //         are truncated by kernel and dropped, see io_stats::dgrams_truncated, so only set a
+  //         smaller size when the max datagram size of protocol is known.
+  YOPT_S_DGRAM_RECV_BATCH,
+
+  // Sets whether use the bounded lock-free ring as event queue instead of the mutex queue
+  // params: capacity : int(0), 0 to use mutex queue
+  // remark: only take effect when io_service not running
+  YOPT_S_EVENT_RING,
+
+  // Set the delay in milliseconds to start next connect attempt when the previous one not complete,
+  // the endpoints of host are connected staggered with families interleaved, see RFC 8305
+  // params: delay : int(YASIO_CONNECT_ATTEMPT_DELAY), 0 to try next endpoint only when failed
+  YOPT_S_CONNECT_ATTEMPT_DELAY,
+
+  // Set max staleness in seconds of dns record after cache timeout, the client channels connect
+  // with the stale record while it's refreshing at background, the record also refreshed at
+  // background after the prefetch threshold, see YOPT_S_DNS_PREFETCH_THRESHOLD.
+  // params: dns_max_staleness : int(YASIO_DNS_MAX_STALENESS), 0 to resolve after timeout
+  // remark: only works without c-ares
+  YOPT_S_DNS_MAX_STALENESS,
+
+  // Set the age in percent of dns cache timeout to refresh the dns record at background, the
+  // records referenced by open channels are checked periodically, not only when channel open.
+  // params: percent : int(YASIO_DNS_PREFETCH_THRESHOLD), 1~100
+  // remark: only works without c-ares
+  YOPT_S_DNS_PREFETCH_THRESHOLD,
+
   // Sets channel length field based frame decode function, native C++ ONLY
   // params: index:int, func:decode_len_fn_t*
   YOPT_C_LFBFD_FN = 101,
@@ -193,6 +248,12 @@ enum
   // params: transport:transport_handle_t
   YOPT_T_BIND_UDP,
 
+  // Sets channel private recv buffer size of transports
+  // params: index:int, size:int(YASIO_INET_BUFFER_SIZE)
+  // remark: when less than YASIO_INET_BUFFER_SIZE, the transports recv with the buffer shared by
+  //         io_service, and only keep the remain data of partial frame at private buffer.
+  YOPT_C_RECV_BUFFER_SIZE,
+
   // Sets io_base sockopt
   // params: io_base*,level:int,optname:int,optval:int,optlen:int
   YOPT_SOCKOPT = 201,
@@ -231,6 +292,22 @@ enum
      https://docs.microsoft.com/en-us/windows/win32/winsock/using-so-reuseaddr-and-so-exclusiveaddruse
   */
   YCF_EXCLUSIVEADDRUSE = 1 << 10,
+
+  /* Whether coalesce the datagrams to same destination with UDP_SEGMENT(GSO) at linux,
+     remark: the kernel 4.18+ required, fallback to send datagrams one by one when unsupported.
+  */
+  YCF_UDP_GSO = 1 << 11,
+
+  /* Whether the udp server demultiplex peers by one socket, the sessions share the server socket
+     instead of connect a new socket per peer, remark: only for udp & kcp server.
+  */
+  YCF_UDP_DEMUX = 1 << 12,
+
+  /* Whether deliver the received frames as slices of pooled receive blocks without copy, only
+     the frames straddle blocks are copied, see io_event::packet_view.
+     remark: the slices hold the block until events destroyed.
+  */
+  YCF_RECV_SLICES = 1 << 13,
 };
 
 // event kinds
@@ -241,6 +318,28 @@ enum
   YEK_PACKET,
 };
 
+// The io_service statistics, the counters are monotonic and could be sampled at any thread,
+// i.e. the accept rate is delta of 'accepted' by sample interval.
+struct io_stats
+{
+  std::atomic<unsigned long long> accepted{0};       // tcp connections accepted
+  std::atomic<unsigned long long> accept_failed{0};  // accept failed, exclude EWOULDBLOCK
+  std::atomic<unsigned long long> accept_batches{0}; // loop iterations accepted connections
+  std::atomic<unsigned long long> accept_budget_exhausted{0}; // batches stop by accept budget
+  std::atomic<unsigned long long> read_budget_exhausted{0};   // transport reads stop by budget
+  std::atomic<unsigned long long> write_budget_exhausted{0};  // transport writes stop by budget
+  std::atomic<unsigned long long> wakeups{0};            // interrupter signaled
+  std::atomic<unsigned long long> wakeups_suppressed{0}; // interrupt coalesced by pending wakeup
+  std::atomic<unsigned long long> dgram_recv_calls{0}; // udp server receive calls got datagrams
+  std::atomic<unsigned long long> dgrams_received{0};  // udp server datagrams received
+  std::atomic<unsigned long long> dgrams_truncated{0}; // udp server datagrams dropped by truncate
+  std::atomic<unsigned long long> dns_cache_hits{0};   // resolve served by shared dns cache
+  std::atomic<unsigned long long> dns_cache_misses{0}; // resolve queried by resolver threads
+  std::atomic<unsigned long long> dns_queries_coalesced{0}; // resolve wait the query in flight
+  std::atomic<unsigned long long> dns_stale_hits{0};        // resolve served by stale dns record
+  std::atomic<unsigned long long> dns_prefetches{0};        // dns record refreshed at background
+};
+
 // class fwds
 class highp_timer;
 class io_send_op;
@@ -268,7 +367,11 @@ typedef highp_timer_ptr deadline_timer_ptr;
 typedef std::function<void()> light_timer_cb_t;
 typedef std::function<bool()> timer_cb_t;
 typedef std::pair<highp_timer*, timer_cb_t> timer_impl_t;
+#if !defined(YASIO_DISABLE_TIMER_WHEEL)
+typedef timer_wheel<timer_impl_t> timer_wheel_t;
+#endif
 typedef std::function<void(event_ptr&&)> io_event_cb_t;
+typedef std::function<void(event_ptr* events, int count)> io_event_batch_cb_t;
 typedef std::function<int(void* ptr, int len)> decode_len_fn_t;
 typedef std::function<int(std::vector<ip::endpoint>&, const char*, unsigned short)> resolv_fn_t;
 typedef std::function<void(const char*)> print_fn_t;
@@ -336,6 +439,10 @@ public:
   io_service& service_;
   std::chrono::microseconds duration_;
   std::chrono::time_point<steady_clock_t> expire_time_;
+#if !defined(YASIO_DISABLE_TIMER_WHEEL)
+  // The node of io_service timer wheel, nullptr when the timer not scheduled
+  timer_wheel_t::node* wheel_node_ = nullptr;
+#endif
 };
 
 struct io_base
@@ -452,6 +559,15 @@ private:
   // The timer for check resolve & connect timeout
   highp_timer timer_;
 
+  // The timer to start next connect attempt, see YOPT_S_CONNECT_ATTEMPT_DELAY
+  highp_timer attempt_timer_;
+
+  // The index of remote_eps_ to connect at next attempt
+  int next_ep_ = 0;
+
+  // The connect attempts in flight except socket_, the winner will be swapped to socket_
+  std::vector<std::shared_ptr<xxsocket>> attempts_;
+
   struct __unnamed01
   {
     int max_frame_length    = YASIO_SZ(10, M); // 10MBytes
@@ -462,6 +578,9 @@ private:
   } lfb_;
   decode_len_fn_t decode_len_;
 
+  // The private recv buffer size of transports, see YOPT_C_RECV_BUFFER_SIZE
+  int rbuf_size_ = YASIO_INET_BUFFER_SIZE;
+
   /*
   !!! for tcp/udp client to bind local specific network adapter, empty for any
   */
@@ -476,10 +595,21 @@ private:
   std::string remote_host_;
   std::vector<ip::endpoint> remote_eps_;
 
+  // The key of shared dns record which the channel resolving with
+  std::string dns_key_;
+
   ip::endpoint multiaddr_;
 
-  // Current it's only for UDP
+  // Current it's only for UDP, the recvmmsg slab when dgram_slot_size_ > 0
   std::vector<char> buffer_;
+  int dgram_slot_size_ = 0;
+
+  // The udp server sessions demultiplexed by peer, see YCF_UDP_DEMUX
+  std::unordered_map<ip::endpoint, transport_handle_t, ip::endpoint_hash, ip::endpoint_equal>
+      dgram_sessions_;
+
+  // The demultiplexed sessions wait the server socket writable
+  std::vector<transport_handle_t> dgram_writers_;
 
 #if defined(YASIO_HAVE_SSL)
   ssl_auto_handle ssl_;
@@ -490,7 +620,7 @@ private:
 #endif
 };
 
-class io_send_op
+class io_send_op : public concurrency::mpsc_node
 {
 public:
   io_send_op(std::vector<char>&& buffer, std::function<void()>&& handler)
@@ -504,6 +634,9 @@ public:
 
   YASIO__DECL virtual int perform(io_transport* transport, const void* buf, int n);
 
+  // The destination of datagram, nullptr for connected transport
+  virtual const ip::endpoint* destination() const { return nullptr; }
+
 #if !defined(YASIO_DISABLE_OBJECT_POOL)
   DEFINE_CONCURRENT_OBJECT_POOL_ALLOCATION(io_send_op, 512)
 #endif
@@ -518,6 +651,7 @@ public:
   {}
 
   YASIO__DECL int perform(io_transport* transport, const void* buf, int n) override;
+  const ip::endpoint* destination() const override { return &destination_; }
 #if !defined(YASIO_DISABLE_OBJECT_POOL)
   DEFINE_CONCURRENT_OBJECT_POOL_ALLOCATION(io_sendto_op, 512)
 #endif
@@ -537,11 +671,36 @@ public:
 
   io_channel* get_context() const { return ctx_; }
 
-  virtual ~io_transport() {}
+  virtual ~io_transport()
+  {
+    if (block_)
+      block_->release();
+  }
 
 protected:
   bool is_open() const { return is_valid() && socket_ && socket_->is_open(); }
 
+  // Whether the socket is shared with server channel, i.e. the udp demultiplexed session
+  bool is_shared_socket() const
+  {
+    return socket_ == ctx_->socket_ && (ctx_->properties_ & YCM_SERVER);
+  }
+
+  // Whether recv with the buffer shared by io_service, see YOPT_C_RECV_BUFFER_SIZE
+  bool is_shared_rbuf() const { return !block_ && buffer_size_ < YASIO_INET_BUFFER_SIZE; }
+
+  // Gets the recv buffer, the pooled block when YCF_RECV_SLICES specified
+  YASIO__DECL char* recv_buffer();
+
+  // Prepare the recv buffer with pending data before read, returns the capacity
+  YASIO__DECL int prepare_recv_buffer();
+
+  // Hold the remain data of partial frame at private buffer after unpack
+  YASIO__DECL void hold_recv_data(const char* data, int size);
+
+  // Allocate the private recv buffer, the old content discarded
+  YASIO__DECL void reserve_recv_buffer(int capacity);
+
   std::vector<char> fetch_packet()
   {
     expected_size_ = -1;
@@ -561,10 +720,13 @@ protected:
   YASIO__DECL int call_read(void* data, int size, int& error);
   YASIO__DECL bool call_write(io_send_op*, int& error, int& internal_ec);
 
+  // Gather the pending ops from front into one system call, returns false if unsupported
+  YASIO__DECL virtual bool call_writev(io_send_op*, int& error, int& internal_ec);
+
   // Call at io_service
   YASIO__DECL virtual int do_read(int& error);
 
-  // Call at io_service, try flush pending packet
+  // Call at io_service, flush pending packets until kernel buffer full or write budget exhausted
   virtual bool do_write(long long& max_wait_duration);
 
   // Sets the underlying layer socket io primitives.
@@ -577,8 +739,13 @@ protected:
 
   unsigned int id_;
 
-  char buffer_[YASIO_INET_BUFFER_SIZE]; // recv buffer, 64K
-  int wpos_ = 0;                        // recv buffer write pos
+  std::unique_ptr<char[]> buffer_; // private recv buffer, allocated at first read
+  int buffer_capacity_ = 0;        // private recv buffer capacity
+  int buffer_size_;                // private recv buffer size, see YOPT_C_RECV_BUFFER_SIZE
+  int wpos_ = 0;                   // recv buffer write pos
+  int rpos_ = 0;                   // recv buffer read pos, always 0 when no block_
+
+  buffer_block* block_ = nullptr; // recv block, frames delivered as slices of it
 
   std::vector<char> expected_packet_;
   int expected_size_ = -1;
@@ -587,8 +754,33 @@ protected:
 
   std::function<int(const void*, int)> write_cb_;
   std::function<int(void*, int)> read_cb_;
+  std::function<int(const io_vec*, int)> writev_cb_; // empty when gather write unsupported
+
+  concurrency::mpsc_queue<io_send_op> send_queue_;
 
-  concurrency::concurrent_queue<io_send_op_ptr> send_queue_;
+  // The total bytes sent by call_write & call_writev, used to limit the bytes of one do_write
+  unsigned long long bytes_sent_ = 0;
+
+  // Whether the transport in the active list of io_service, only access at io_service thread
+  bool active_ = false;
+
+  // Whether the data may left in socket by read budget exhausted, cleared when read until EAGAIN
+  bool read_pending_ = false;
+
+  // Whether the write interest registered, only when send queue blocked by full kernel buffer
+  bool pollout_registered_ = false;
+
+  // Whether the transport in the activated list, set by write or close request
+  std::atomic<bool> activated_{false};
+
+  // The index at io_service::transports_, for O(1) removal
+  size_t slot_ = 0;
+
+  // The index at io_service::activated_transports_, only access with activated_mtx_ locked
+  size_t activated_slot_ = 0;
+
+  // The index at io_channel::dgram_writers_ when shared socket wait writable
+  size_t writer_slot_ = 0;
 
 public:
   // The user data
@@ -605,6 +797,9 @@ class io_transport_tcp : public io_transport
 
 public:
   io_transport_tcp(io_channel* ctx, std::shared_ptr<xxsocket>& s);
+
+protected:
+  YASIO__DECL void set_primitives() override;
 };
 #if defined(YASIO_HAVE_SSL)
 class io_transport_ssl : public io_transport_tcp
@@ -638,6 +833,9 @@ protected:
   YASIO__DECL int write_to(std::vector<char>&&, const ip::endpoint&,
                            std::function<void()>&&) override;
 
+  // Send the pending datagrams with sendmmsg at linux
+  YASIO__DECL bool call_writev(io_send_op*, int& error, int& internal_ec) override;
+
   YASIO__DECL void set_primitives() override;
 
   // ensure peer valid, if not, assign from ctx_->remote_eps_[0]
@@ -648,6 +846,11 @@ protected:
 
   mutable ip::endpoint peer_;
   bool connected_ = false;
+  bool gso_; // whether coalesce datagrams with UDP_SEGMENT
+
+  // The datagram received by server channel for demultiplexed session
+  const char* dgram_ = nullptr;
+  int dgram_size_    = 0;
 };
 #if defined(YASIO_HAVE_KCP)
 class io_transport_kcp : public io_transport_udp
@@ -677,19 +880,41 @@ public:
       : timestamp_(highp_clock()), cindex_(cindex), kind_(type), status_(0),
         transport_(std::move(transport)), packet_(std::move(packet))
   {}
+  io_event(int cindex, int type, buffer_slice slice, transport_handle_t transport)
+      : timestamp_(highp_clock()), cindex_(cindex), kind_(type), status_(0),
+        transport_(std::move(transport)), slice_(std::move(slice))
+  {}
   io_event(io_event&& rhs)
       : timestamp_(rhs.timestamp_), cindex_(rhs.cindex_), kind_(rhs.kind_), status_(rhs.status_),
-        transport_(std::move(rhs.transport_)), packet_(std::move(rhs.packet_))
+        transport_(std::move(rhs.transport_)), packet_(std::move(rhs.packet_)),
+        slice_(std::move(rhs.slice_))
   {}
 
-  ~io_event() {}
+  // The packet buffer return to packet_pool automatically
+  ~io_event() { packet_pool::instance().recycle(packet_); }
 
   int cindex() const { return cindex_; }
 
   int kind() const { return kind_; }
   int status() const { return status_; }
 
-  std::vector<char>& packet() { return packet_; }
+  // The packet, copy out and release the slice if the packet delivered as slice
+  std::vector<char>& packet()
+  {
+    if (slice_)
+    {
+      packet_.assign(slice_.data(), slice_.data() + slice_.size());
+      slice_.reset();
+    }
+    return packet_;
+  }
+
+  // The packet data without copy, valid until event destroyed or packet() called
+  cxx17::string_view packet_view() const
+  {
+    return slice_ ? cxx17::string_view(slice_.data(), slice_.size())
+                  : cxx17::string_view(packet_.data(), packet_.size());
+  }
 
   transport_handle_t transport() const { return transport_; }
 
@@ -706,6 +931,7 @@ private:
   int status_;
   transport_handle_t transport_;
   std::vector<char> packet_;
+  buffer_slice slice_;
 };
 
 class io_service // lgtm [cpp/class-many-fields]
@@ -749,6 +975,10 @@ public:
   // any other game engines' render thread.
   YASIO__DECL void dispatch(int count = 512);
 
+  // dispatch at most 'count' events by one callback with contiguous events, the events can be
+  // released by callback, otherwise destroyed after callback returns.
+  YASIO__DECL void dispatch_batch(int count, const io_event_batch_cb_t& cb);
+
   // set option, see enum YOPT_XXX
   YASIO__DECL void set_option(int opt, ...);
   YASIO__DECL void set_option_internal(int opt, va_list args);
@@ -820,10 +1050,30 @@ public:
   // Gets channel by index
   YASIO__DECL io_channel* channel_at(size_t cindex) const;
 
+  // Gets the statistics, thread safe
+  const io_stats& stats() const { return stats_; }
+
 private:
   YASIO__DECL void schedule_timer(highp_timer*, timer_cb_t&&);
   YASIO__DECL void remove_timer(highp_timer*);
 
+#if !defined(YASIO_DISABLE_TIMER_WHEEL)
+  static timer_wheel_t::tick_type to_wheel_tick(long long usec)
+  { // round up, avoid timer fire early
+    return static_cast<timer_wheel_t::tick_type>((usec + YASIO_TIMER_WHEEL_TICK - 1) /
+                                                 YASIO_TIMER_WHEEL_TICK);
+  }
+  static timer_wheel_t::tick_type current_wheel_tick()
+  {
+    return static_cast<timer_wheel_t::tick_type>(highp_clock() / YASIO_TIMER_WHEEL_TICK);
+  }
+  static timer_wheel_t::tick_type expires_tick(highp_timer* timer)
+  {
+    return to_wheel_tick(std::chrono::duration_cast<std::chrono::microseconds>(
+                             timer->expire_time_.time_since_epoch())
+                             .count());
+  }
+#else
   std::vector<timer_impl_t>::iterator find_timer(highp_timer* key)
   {
     return std::find_if(timer_queue_.begin(), timer_queue_.end(),
@@ -836,10 +1086,41 @@ private:
                 return lhs.first->wait_duration() > rhs.first->wait_duration();
               });
   }
+#endif
 
   // Start a async resolve, It's only for internal use
   YASIO__DECL void start_resolve(io_channel*);
 
+#if !defined(YASIO_HAVE_CARES)
+  // Apply the shared dns record to channel when the query complete
+  YASIO__DECL void finish_resolve(io_channel*);
+
+  // Refresh the dns record of ready channel at background before or after it's expired
+  YASIO__DECL void refresh_resolve(io_channel*);
+
+  // Start the timer to refresh the dns records referenced by open channels
+  YASIO__DECL void schedule_dns_refresh();
+
+  // Refresh the dns records reached prefetch age, returns whether any record still referenced
+  YASIO__DECL bool refresh_dns_records();
+
+  // The age of dns record to refresh at background, see YOPT_S_DNS_PREFETCH_THRESHOLD
+  highp_time_t dns_prefetch_age() const
+  {
+    return options_.dns_cache_timeout_ * options_.dns_prefetch_threshold_ / 100;
+  }
+
+  // Queue the dns record to query, must call with dns_->mtx locked
+  YASIO__DECL void enqueue_resolve(const std::string& key);
+
+  // The resolver thread, perform the queries of dns->queue until the service stopped
+  struct dns_state;
+  YASIO__DECL void resolver_loop(std::shared_ptr<dns_state> dns);
+
+  // Stop the resolver threads without waiting, the queries in flight complete at background
+  YASIO__DECL void stop_resolvers();
+#endif
+
   YASIO__DECL void init(const io_hostent* channel_eps /* could be nullptr */, int channel_count);
   YASIO__DECL void cleanup();
 
@@ -850,18 +1131,36 @@ private:
 
   YASIO__DECL void open_internal(io_channel*);
 
-  YASIO__DECL void process_transports(fd_set* fds_array, long long& max_wait_duration);
-  YASIO__DECL void process_channels(fd_set* fds_array);
+  YASIO__DECL void process_transports(long long& max_wait_duration);
+  YASIO__DECL void process_channels();
   YASIO__DECL void process_timers();
 
   YASIO__DECL void interrupt();
 
+  // Request the io_service thread to process the transport at next loop iteration, thread safe
+  YASIO__DECL void activate(transport_handle_t);
+  // Add transport to the active list, only call at io_service thread
+  YASIO__DECL void activate_internal(transport_handle_t);
+
   YASIO__DECL long long get_wait_duration(long long usec);
 
-  YASIO__DECL int do_select(fd_set* fds_array, long long max_wait_duration);
+  YASIO__DECL int do_poll(long long max_wait_duration);
 
   YASIO__DECL void do_nonblocking_connect(io_channel*);
-  YASIO__DECL void do_nonblocking_connect_completion(io_channel*, fd_set* fds_array);
+  YASIO__DECL void do_nonblocking_connect_completion(io_channel*);
+
+  // Interleave the address families of endpoints, i.e. [v6,v6,v4,v4] --> [v6,v4,v6,v4]
+  YASIO__DECL static void interleave_endpoints(std::vector<ip::endpoint>&);
+
+  // Start connect the next endpoint of channel, returns false when all endpoints failed
+  YASIO__DECL bool start_connect_attempt(io_channel*, int& error);
+
+  // Check the connect attempts in flight, returns 0 when the winner swapped to channel socket,
+  // EINPROGRESS when still connecting, otherwise the error of last failed attempt
+  YASIO__DECL int check_connect_attempts(io_channel*);
+
+  // Close the connect attempts in flight except channel socket
+  YASIO__DECL void close_connect_attempts(io_channel*);
 
 #if defined(YASIO_HAVE_SSL)
   YASIO__DECL void init_ssl_context();
@@ -878,7 +1177,8 @@ private:
     if (ares_outstanding_work_ > 0)
       --ares_outstanding_work_;
   }
-  YASIO__DECL void process_ares_requests(fd_set* fds_array);
+  static void ares_sock_state_cb(void* data, socket_native_type fd, int readable, int writable);
+  YASIO__DECL void process_ares_requests();
   YASIO__DECL void init_ares_channel();
   YASIO__DECL void cleanup_ares_channel();
 #endif
@@ -900,13 +1200,15 @@ private:
   // The major non-blocking event-loop
   YASIO__DECL void run(void);
 
-  YASIO__DECL bool do_read(transport_handle_t, fd_set* fds_array, long long& max_wait_duration);
+  // Read until EAGAIN or the read budget exhausted, max_wait_duration set 0 when budget exhausted
+  YASIO__DECL bool do_read(transport_handle_t, long long& max_wait_duration);
   YASIO__DECL bool do_write(transport_handle_t transport, long long& max_wait_duration)
   {
     return transport->do_write(max_wait_duration);
   }
-  YASIO__DECL void unpack(transport_handle_t, int bytes_expected, int bytes_transferred,
-                          int bytes_to_strip, long long& max_wait_duration);
+  // Decode all complete frames in buffer with a read cursor, returns the count of frames, -1 when
+  // packet invalid
+  YASIO__DECL int unpack(transport_handle_t, int bytes_transferred);
 
   // The op mask will be cleared, the state will be set CLOSED when clear_state is 'true'
   YASIO__DECL bool cleanup_io(io_base* obj, bool clear_state = true);
@@ -914,6 +1216,9 @@ private:
   YASIO__DECL void handle_close(transport_handle_t);
   YASIO__DECL void handle_event(event_ptr event);
 
+  // Post the events collected by handle_event to event queue at once, see do_dgram_recv
+  YASIO__DECL void post_pending_events();
+
   // new/delete client socket connection channel
   // please call this at initialization, don't new channel at runtime
   // dynmaically: because this API is not thread safe.
@@ -933,7 +1238,7 @@ private:
 
   // supporting server
   YASIO__DECL void do_nonblocking_accept(io_channel*);
-  YASIO__DECL void do_nonblocking_accept_completion(io_channel*, fd_set* fds_array);
+  YASIO__DECL void do_nonblocking_accept_completion(io_channel*);
 
   YASIO__DECL static const char* strerror(int error);
 
@@ -942,6 +1247,24 @@ private:
   */
   YASIO__DECL transport_handle_t do_dgram_accept(io_channel*, const ip::endpoint& peer);
 
+  // Receive datagrams of udp server channel, and dispatch them to the session transports,
+  // returns the count of datagrams received
+  YASIO__DECL int do_dgram_recv(io_channel*);
+
+  // Gets the session transport of peer, make a new one like tcp accept if not exist
+  YASIO__DECL transport_handle_t dgram_transport_of(io_channel*, const ip::endpoint& peer);
+
+  // Dispatch the datagram received by server channel to the session transport
+  YASIO__DECL void handle_dgram(transport_handle_t, const char* data, int size);
+
+  // The demultiplexed session wait the shared server socket writable, POLLOUT registered once
+  YASIO__DECL void wait_dgram_writable(transport_handle_t);
+  YASIO__DECL void cancel_dgram_writable(transport_handle_t);
+  YASIO__DECL void cancel_dgram_writable(io_channel*);
+
+  // Activate the sessions wait writable when the server socket writable
+  YASIO__DECL void process_dgram_writable();
+
   int local_address_family() const { return ((ipsv_ & ipsv_ipv4) || !ipsv_) ? AF_INET : AF_INET6; }
 
 private:
@@ -950,6 +1273,11 @@ private:
   std::thread::id worker_id_;
 
   concurrency::concurrent_queue<event_ptr, true> events_;
+  std::unique_ptr<concurrency::ring_queue<event_ptr>> event_ring_; // see YOPT_S_EVENT_RING
+  std::vector<event_ptr> batch_events_; // the reused storage of dispatch_batch
+  std::vector<event_ptr> pending_events_; // the events collected when batching_events_
+  bool batching_events_ = false;
+  std::vector<char> shared_rbuf_;       // the recv buffer shared by transports
 
   std::vector<io_channel*> channels_;
 
@@ -959,6 +1287,19 @@ private:
   std::vector<transport_handle_t> transports_;
   std::vector<transport_handle_t> tpool_;
 
+  // The transports index by socket descriptor, used to lookup the ready transports
+  std::unordered_map<socket_native_type, transport_handle_t> transport_map_;
+
+  // The transports need to be processed at current loop iteration
+  std::vector<transport_handle_t> active_transports_;
+
+  // The udp server channels which sessions wait writable, see wait_dgram_writable
+  std::vector<io_channel*> dgram_writable_channels_;
+
+  // The transports activated by write or close request
+  std::recursive_mutex activated_mtx_;
+  std::vector<transport_handle_t> activated_transports_;
+
 #if defined(_WIN32)
   std::map<ip::endpoint, transport_handle_t> dgram_clients_;
 #endif
@@ -966,28 +1307,40 @@ private:
   // select interrupter
   select_interrupter interrupter_;
 
+  // Whether the interrupter signaled and not reset by io_service thread yet
+  std::atomic<bool> wakeup_pending_{false};
+
   // timer support timer_pair
+#if !defined(YASIO_DISABLE_TIMER_WHEEL)
+  timer_wheel_t timer_wheel_;
+  // The wheel tick the service planed to wakeup for timers
+  timer_wheel_t::tick_type timer_wakeup_tick_ = static_cast<timer_wheel_t::tick_type>(-1);
+#else
   std::vector<timer_impl_t> timer_queue_;
+#endif
   std::recursive_mutex timer_queue_mtx_;
 
-  // the max nfds for socket.select, must be max_fd + 1
-  int max_nfds_;
-  enum
-  {
-    read_op,
-    write_op,
-    except_op,
-    max_ops,
-  };
-  fd_set fds_array_[max_ops];
+  // The io multiplexing poller, epoll at linux, select at other platforms
+  poller poller_;
 
   // options
   struct __unnamed_options
   {
-    highp_time_t connect_timeout_     = 10LL * std::micro::den;
-    highp_time_t dns_cache_timeout_   = 600LL * std::micro::den;
-    highp_time_t dns_queries_timeout_ = 5LL * std::micro::den;
-    int dns_queries_tries_            = 5;
+    highp_time_t connect_timeout_       = 10LL * std::micro::den;
+    highp_time_t connect_attempt_delay_ = YASIO_CONNECT_ATTEMPT_DELAY * 1000LL;
+    highp_time_t dns_cache_timeout_     = 600LL * std::micro::den;
+    highp_time_t dns_max_staleness_     = YASIO_DNS_MAX_STALENESS * 1000000LL;
+    int dns_prefetch_threshold_         = YASIO_DNS_PREFETCH_THRESHOLD;
+    highp_time_t dns_queries_timeout_   = 5LL * std::micro::den;
+    int dns_queries_tries_              = 5;
+
+    int tcp_backlog_       = YASIO_SOMAXCONN;
+    int accept_budget_     = YASIO_ACCEPT_BUDGET;
+    int read_budget_       = YASIO_READ_BUDGET;
+    int read_frame_budget_ = YASIO_READ_FRAME_BUDGET;
+    int write_budget_      = YASIO_WRITE_BUDGET;
+    int dgram_recv_batch_  = YASIO_DGRAM_RECV_BATCH;
+    int dgram_recv_size_   = YASIO_DGRAM_RECV_SIZE;
 
     bool deferred_event_ = true;
 
@@ -1002,7 +1355,7 @@ private:
 
     bool no_new_thread_ = false;
 
-    // The resolve function
+    // The resolve function, empty for builtin resolve, write with dns_->mtx locked
     resolv_fn_t resolv_;
     // the event callback
     io_event_cb_t on_event_;
@@ -1017,14 +1370,110 @@ private:
   // The ip stack version supported by localhost
   u_short ipsv_ = 0;
 
+  io_stats stats_;
+
 #if defined(YASIO_HAVE_SSL)
   SSL_CTX* ssl_ctx_ = nullptr;
 #endif
 #if defined(YASIO_HAVE_CARES)
   ares_channel ares_         = nullptr; // the ares handle for non blocking io dns resolve support
   int ares_outstanding_work_ = 0;
+#else
+  // The dns record shared by channels, keyed by host, port and address family
+  struct dns_record
+  {
+    std::string host;
+    u_short port = 0;
+    u_short ipsv = 0;   // the ip stack version for builtin resolve
+    resolv_fn_t resolv; // the resolve function when queued, empty for builtin resolve
+    std::vector<ip::endpoint> endpoints;
+    int error              = 0;
+    highp_time_t timestamp = 0;     // the resolved time, 0 when not resolved or failed
+    highp_time_t max_age   = 0;     // the age the record kept when refresh failed
+    bool pending           = false; // whether the query in flight
+  };
+  // The dns records & queries shared with resolver threads, the threads are detached and hold
+  // it, so the service never blocks on the queries in flight at stop
+  struct dns_state
+  {
+    std::unordered_map<std::string, dns_record> cache;
+    std::deque<std::string> queue; // the keys of dns records to query
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool started  = false; // the threads started at first query, see YASIO_DNS_RESOLVER_THREADS
+    bool stopping = false; // the service stopped, the threads exit without touching it
+  };
+  std::shared_ptr<dns_state> dns_;
+
+  // The timer refresh the dns records referenced by open channels, see refresh_dns_records
+  highp_timer dns_refresh_timer_{*this};
+  bool dns_refresh_scheduled_ = false;
 #endif
 }; // io_service
+
+/*
+** Summary: Run multiple io_service event loops, each loop has it's own worker thread and
+**          channels created with same hosts.
+** @remark:
+**   + The server channels open at every loop with SO_REUSEPORT, the kernel load-balances
+**     the incoming connections across the loops, only linux support thus, other platforms
+**     open server channels at the first loop.
+**   + The client channel 'cindex' only open at the loop 'cindex % concurrency'.
+**   + By default, the events of all loops dispatched at the thread who call 'dispatch',
+**     if disable deferred event, the callback will be called at each loop's thread concurrently.
+*/
+class io_service_group
+{
+public:
+  YASIO__DECL io_service_group(int concurrency, const io_hostent* channel_eps, int channel_count);
+  YASIO__DECL ~io_service_group();
+
+  YASIO__DECL void start(io_event_cb_t cb);
+  YASIO__DECL void stop();
+
+  // dispatch at most 'count' events of each loop
+  YASIO__DECL void dispatch(int count = 512);
+
+  // dispatch at most 'count' events of each loop, one batch callback per loop
+  YASIO__DECL void dispatch_batch(int count, const io_event_batch_cb_t& cb);
+
+  // set option to all loops, see enum YOPT_XXX
+  YASIO__DECL void set_option(int opt, ...);
+
+  YASIO__DECL void open(size_t cindex, int kind = YCK_TCP_CLIENT);
+  YASIO__DECL void close(int cindex);
+  YASIO__DECL bool is_open(int cindex) const;
+
+  // The transport operations perform at the loop which owns the transport
+  void close(transport_handle_t thandle) { owner_of(thandle).close(thandle); }
+  int write(transport_handle_t thandle, const void* buf, size_t len,
+            std::function<void()> completion_handler = nullptr)
+  {
+    return owner_of(thandle).write(thandle, buf, len, std::move(completion_handler));
+  }
+  int write(transport_handle_t thandle, std::vector<char> buffer,
+            std::function<void()> completion_handler = nullptr)
+  {
+    return owner_of(thandle).write(thandle, std::move(buffer), std::move(completion_handler));
+  }
+  int write_to(transport_handle_t thandle, std::vector<char> buffer, const ip::endpoint& to,
+               std::function<void()> completion_handler = nullptr)
+  {
+    return owner_of(thandle).write_to(thandle, std::move(buffer), to,
+                                      std::move(completion_handler));
+  }
+
+  size_t size() const { return services_.size(); }
+  io_service& at(size_t index) const { return *services_[index]; }
+
+  static io_service& owner_of(transport_handle_t thandle)
+  {
+    return thandle->get_context()->get_service();
+  }
+
+private:
+  std::vector<std::unique_ptr<io_service>> services_;
+}; // io_service_group
 } // namespace inet
 } /* namespace yasio */
 